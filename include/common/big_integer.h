@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file big_integer.h
+ * @author lazypaws
+ * @brief Defines arbitrary-precision integers for MeowScript
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/pch.h"
+
+namespace meow::common {
+    /**
+     * @class BigInteger
+     * @brief An arbitrary-precision signed integer
+     * @details Stored as a sign and a magnitude of 32-bit limbs, least significant first, without leading zero limbs.
+     * Zero has no limbs and is never negative
+     */
+    class BigInteger {
+    public:
+        // Below this many limbs, schoolbook multiplication beats Karatsuba
+        static constexpr size_t KARATSUBA_THRESHOLD = 32;
+
+        /**
+         * @brief The default constructor for BigInteger
+         * @details Initializes zero
+         */
+        BigInteger() = default;
+
+        /**
+         * @brief Constructs a BigInteger from a machine integer
+         * @param[in] value The integer to convert
+         */
+        BigInteger(int64_t value);
+
+        /**
+         * @brief Checks if the integer is negative
+         * @return 'true' if the integer is less than zero, 'false' otherwise
+         */
+        bool isNegative() const noexcept {
+            return negative;
+        }
+
+        /**
+         * @brief Checks if the integer is zero
+         * @return 'true' if the integer is zero, 'false' otherwise
+         */
+        bool isZero() const noexcept {
+            return limbs.empty();
+        }
+
+        /**
+         * @brief Gets how many bits the magnitude takes
+         * @return The position of the highest set bit plus one, 0 for zero
+         */
+        uint64_t bitLength() const noexcept;
+
+        /**
+         * @brief Checks if the integer fits in an int64_t
+         * @return 'true' if toInt() is exact, 'false' otherwise
+         */
+        bool fitsInt() const noexcept;
+
+        /**
+         * @brief Converts to a machine integer
+         * @return The integer value
+         * @warning Only meaningful if fitsInt() is 'true'
+         */
+        int64_t toInt() const noexcept;
+
+        /**
+         * @brief Converts to the nearest double
+         * @return The floating-point value, infinite if out of range
+         */
+        double toDouble() const noexcept;
+
+        /**
+         * @brief Converts to a decimal string
+         * @return The decimal representation, with a leading '-' if negative
+         */
+        std::string toString() const;
+
+        BigInteger operator-() const;
+        friend BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs);
+        friend BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs);
+        friend BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs);
+
+        /**
+         * @name Bitwise operators
+         * @details Work on the two's complement of the integers, as if they were sign-extended forever like int64_t
+         */
+        BigInteger operator~() const;
+        friend BigInteger operator&(const BigInteger& lhs, const BigInteger& rhs);
+        friend BigInteger operator|(const BigInteger& lhs, const BigInteger& rhs);
+        friend BigInteger operator^(const BigInteger& lhs, const BigInteger& rhs);
+
+        /**
+         * @brief Divides with truncation toward zero, like C++ integer division
+         * @param[in] dividend The integer to divide
+         * @param[in] divisor The integer to divide by
+         * @param[out] quotient The truncated quotient
+         * @param[out] remainder The remainder, with the sign of the dividend
+         * @warning The divisor must not be zero
+         */
+        static void divide(const BigInteger& dividend, const BigInteger& divisor, BigInteger& quotient, BigInteger& remainder);
+
+        /**
+         * @brief Raises to a power by repeated squaring
+         * @param[in] exponent The non-negative exponent
+         * @return This integer raised to the exponent
+         */
+        BigInteger pow(uint64_t exponent) const;
+
+        /**
+         * @brief Shifts left, multiplying by a power of two
+         * @param[in] bits The number of bits to shift by
+         */
+        BigInteger shiftLeft(uint64_t bits) const;
+
+        /**
+         * @brief Shifts right arithmetically, rounding toward negative infinity like int64_t
+         * @param[in] bits The number of bits to shift by
+         */
+        BigInteger shiftRight(uint64_t bits) const;
+
+        /**
+         * @brief Compares two integers
+         * @return A negative value, zero or a positive value if lhs is less than, equal to or greater than rhs
+         */
+        friend int compare(const BigInteger& lhs, const BigInteger& rhs) noexcept;
+
+        friend bool operator==(const BigInteger& lhs, const BigInteger& rhs) noexcept {
+            return lhs.negative == rhs.negative && lhs.limbs == rhs.limbs;
+        }
+    private:
+        bool negative = false;
+        std::vector<uint32_t> limbs;
+
+        void normalize() noexcept;
+        static BigInteger bitwise(const BigInteger& lhs, const BigInteger& rhs, uint32_t (*op)(uint32_t, uint32_t));
+    };
+}
@@ -10,12 +10,27 @@
 #pragma once
 
 #include "common/value.h"
+#include "common/big_integer.h"
 #include "memory/meow_object.h"
 #include "memory/gc_visitor.h"
 #include "pch.h"
 
+namespace meow::memory {
+    class MemoryManager;
+}
+
 namespace meow::runtime {
     struct Chunk;
+    class FeedbackVector;
+}
+
+namespace meow::runtime::module {
+    struct ModuleRecord;
+}
+
+namespace meow::jit {
+    class CompiledCode;
+    struct LoopTraces;
 }
 
 namespace meow::common {
@@ -133,14 +148,61 @@ namespace meow::common {
         void trace([[maybe_unused]] meow::memory::GCVisitor& visitor) override {}
     };
 
+    /**
+     * @struct ObjBigInt
+     * @brief Represents an integer too large for Int in MeowScript
+     * @details Produced when Int arithmetic overflows. Results that fit in Int again are always demoted back,
+     * so an ObjBigInt never holds a value representable as Int
+     */
+    struct ObjBigInt : meow::memory::MeowObject {
+    private:
+        BigInteger data;
+    public:
+        /**
+         * @brief Constructs an ObjBigInt from an arbitrary-precision integer
+         * @param[in] value The integer to hold
+         */
+        ObjBigInt(BigInteger value) : data(std::move(value)) {}
+
+        /**
+         * @brief Gets the constant reference to the integer
+         * @return The read-only integer
+         */
+        const BigInteger& get() const {
+            return data;
+        }
+
+        /**
+         * @brief Trace all reachable MeowObjects for Garbage Collector
+         * @param[in,out] visitor The Visitor that performs the tracing
+         * @note This parameter is unused because ObjBigInt holds no traceable objects
+         * @see meow::memory::MeowObject::trace
+         */
+        void trace([[maybe_unused]] meow::memory::GCVisitor& visitor) override {}
+    };
+
     /**
      * @struct ObjString
      * @brief Represents a string in MeowScript
-     * @details A wrapper around an \c std::string to represent string
+     * @details A wrapper around an \c std::string to represent string.
+     * Strings never change, but appending to the result of a concatenation hands its buffer to the new string.
+     * The old string then reads its characters back from the new one the first time it's used again, which
+     * makes building a string with \c s = s + x linear instead of quadratic
      */
     struct ObjString : meow::memory::MeowObject {
     private:
-        std::string data;
+        mutable std::string data;
+        mutable ObjString* successor = nullptr;     // Took over the buffer, this string is its first 'length' characters
+        size_t length = 0;
+        bool growable = false;                      // Made by appending, so a later append may take its buffer
+
+        // Copies the characters back from whichever string owns the buffer now
+        void materialize() const {
+            const ObjString* owner = successor;
+            while (owner->successor) owner = owner->successor;
+            data.assign(owner->data, 0, length);
+            successor = nullptr;
+        }
     public:
         /**
          * @brief The default constructor for  ObjString
@@ -155,11 +217,31 @@ namespace meow::common {
          */
         ObjString(const std::string& str) : data(str) {}
 
+        /**
+         * @brief Constructs the concatenation of a string and a suffix
+         * @details Takes the buffer of 'prefix' over and appends in place if 'prefix' was itself made by appending,
+         * otherwise copies. The buffer grows geometrically, so repeated appends cost the appended characters only
+         * @param[in,out] prefix The string appended to
+         * @param[in] suffix The characters to append, which must not be those of 'prefix'
+         */
+        ObjString(ObjString& prefix, std::string_view suffix) : growable(true) {
+            if (!prefix.growable || prefix.successor) {
+                data.reserve(prefix.size() + suffix.size());
+                data.append(prefix.get()).append(suffix);
+                return;
+            }
+            data = std::move(prefix.data);
+            prefix.successor = this;
+            prefix.length = data.size();
+            data.append(suffix);
+        }
+
         /**
          * @brief Gets the constant reference to string
          * @return The read-only string
          */
         const std::string& get() const {
+            if (successor) [[unlikely]] materialize();
             return data;
         }
 
@@ -169,7 +251,7 @@ namespace meow::common {
          * @return The read-only character at specified index
          */
         char get(size_t index) const {
-            return data[index];
+            return get()[index];
         }
 
         /** 
@@ -177,7 +259,7 @@ namespace meow::common {
          * @return Size of string
          */
         size_t size() const {
-            return data.size();
+            return successor ? length : data.size();
         }
 
         /** 
@@ -185,33 +267,36 @@ namespace meow::common {
          * @return 'true' if the string is empty, 'false' otherwise
          */
         bool empty() const {
-            return data.empty();
+            return size() == 0;
         }
 
         /**
          * @brief Gets an iterator to browse the string
          * @return An iterator to the beginning of the string
+         * @note Read-only, a later string may share the characters
          */
-        inline constexpr std::string::iterator begin() noexcept {
-            return data.begin();
+        inline std::string::const_iterator begin() const noexcept {
+            return get().begin();
         }
 
         /**
          * @brief Gets an iterator to browse the string
          * @return An iterator to the end of the string
          */
-        inline constexpr std::string::iterator end() noexcept {
-            return data.end();
+        inline std::string::const_iterator end() const noexcept {
+            return get().end();
         }
 
         /**
          * @brief Trace all reachable MeowObjects for Garbage Collector
          * @details This method is one of the most important part of the Garbage Collector mechanism. It's called by GC to mark all of reachable MeowObjects
          * @param[in,out] visitor The Visitor that performs the tracing
-         * @note This parameter is unused because ObjString holds no traceable objects
+         * @note A string whose buffer moved on keeps the string holding it alive
          * @see meow::memory::MeowObject::trace
          */
-        void trace([[maybe_unused]] meow::memory::GCVisitor& visitor) override {}
+        void trace(meow::memory::GCVisitor& visitor) override {
+            if (successor) visitor.visitObject(successor);
+        }
     };
 
     /**
@@ -451,11 +536,58 @@ namespace meow::common {
             return methods.find(key->get()) != methods.end();
         }
 
+        /**
+         * @brief A position in the object that fits in an Int register
+         * @details The bucket in the high 32 bits and the position in that bucket in the low ones.
+         * Buckets hold about one entry each, so stepping costs what the map iterator does and needs no allocation.
+         * A cursor only stays valid until a key is added, which may rehash.
+         * The end cursor doubles as the position before the first entry
+         */
+        using Cursor = Int;
+
+        /**
+         * @brief Gets the cursor past the last entry, which is also the one before the first
+         * @return The end cursor
+         */
+        static constexpr Cursor endCursor() noexcept {
+            return -1;
+        }
+
+        /**
+         * @brief Moves a cursor to the next entry
+         * @param[in] cursor A cursor on an entry, or the end cursor to start over
+         * @return The cursor of the next entry, or the end cursor after the last one
+         */
+        Cursor nextCursor(Cursor cursor) const noexcept {
+            size_t bucket = 0, position = 0;
+            if (cursor != endCursor()) {
+                bucket = static_cast<size_t>(static_cast<uint64_t>(cursor) >> 32);
+                position = static_cast<size_t>(cursor & 0xffffffff) + 1;
+            }
+            for (; bucket < methods.bucket_count(); ++bucket, position = 0) {
+                if (position < methods.bucket_size(bucket)) {
+                    return static_cast<Cursor>((static_cast<uint64_t>(bucket) << 32) | position);
+                }
+            }
+            return endCursor();
+        }
+
+        /**
+         * @brief Gets the entry at a cursor
+         * @param[in] cursor A cursor on an entry
+         * @return The read-only key and value
+         * @warning The cursor must not be the end cursor
+         */
+        const std::pair<const std::string, Value>& entryAt(Cursor cursor) const noexcept {
+            size_t bucket = static_cast<size_t>(static_cast<uint64_t>(cursor) >> 32);
+            return *std::next(methods.cbegin(bucket), static_cast<ptrdiff_t>(cursor & 0xffffffff));
+        }
+
         /**
          * @brief Gets an iterator to browse the object
          * @return An iterator to the beginning of the object
          */
-        inline constexpr std::unordered_map<std::string, Value>::const_iterator begin() const noexcept {
+        inline std::unordered_map<std::string, Value>::const_iterator begin() const noexcept {
             return methods.begin();
         }
 
@@ -463,7 +595,7 @@ namespace meow::common {
          * @brief Gets an iterator to browse the object
          * @return An iterator to the end of the object
          */
-        inline constexpr std::unordered_map<std::string, Value>::const_iterator end() const noexcept {
+        inline std::unordered_map<std::string, Value>::const_iterator end() const noexcept {
             return methods.end();
         }
 
@@ -480,11 +612,62 @@ namespace meow::common {
         }
     };   
 
+    /**
+     * @struct UpvalueDesc
+     * @brief Describes how a closure captures one variable
+     */
     struct UpvalueDesc {
-        bool isLocal = true;
+        bool isLocal = true;    // Captures a register of the enclosing frame, otherwise an upvalue of the enclosing closure
+        bool byValue = false;   // The variable is never assigned after capture, so its value is copied flat
         size_t index;
     };
 
+    /**
+     * @struct ExceptionHandler
+     * @brief An entry of the exception table of a proto
+     * @details Maps a protected range [start, end) of instruction offsets to the offset of its handler.
+     * Inner ranges come before the ranges enclosing them, so the first match is the innermost handler
+     */
+    struct ExceptionHandler {
+        size_t start;
+        size_t end;
+        size_t handler;
+        uint16_t errorRegister;     // Receives the thrown value when the handler is entered
+    };
+
+    /**
+     * @struct ExportSite
+     * @brief A \c GET_EXPORT instruction, its name operand is the index of its site once linked
+     * @details The module is only known when the instruction runs, the site binds to it and its export slot the first time.
+     * Export slots never move, so while the module stays the same reading the export is an indexed load
+     */
+    struct ExportSite {
+        uint16_t name;              // The string constant naming the export
+        Module module = nullptr;
+        uint32_t slot = 0;
+    };
+
+    /**
+     * @struct ImportSite
+     * @brief An \c IMPORT_MODULE instruction, its path operand is the index of its site once linked
+     * @details The module manager resolves the path when it links the module, so importing again costs no path work.
+     * A path that didn't resolve then is resolved when the instruction runs, which reports the error
+     */
+    struct ImportSite {
+        uint16_t path;              // The string constant naming the module
+        meow::runtime::module::ModuleRecord* record = nullptr;
+    };
+
+    /**
+     * @enum Tier
+     * @brief How a proto is being executed, it only ever moves up
+     */
+    enum class Tier : uint8_t {
+        INTERPRETED,    // Generic instructions, collecting feedback
+        QUICKENED,      // Instructions with monomorphic feedback are rewritten into specialized forms
+        COMPILED        // Handed to the JIT, which may have declined it
+    };
+
     /**
      * @struct ObjProto
      * @brief Represents function proto in MeowScript
@@ -492,16 +675,570 @@ namespace meow::common {
     struct ObjProto : meow::memory::MeowObject {
         size_t registers;
         size_t upvalues;
+        size_t arity = 0;
+
+        std::vector<UpvalueDesc> upvalueDescs;
+        std::vector<ExceptionHandler> handlers;
+        std::vector<ExportSite> exportSites;
+        std::vector<ImportSite> importSites;
 
         meow::runtime::Chunk* chunk;
+        Module module = nullptr;    // The module owning the globals this proto refers to
+        bool linked = false;        // Set once global names in the chunk are resolved to slots
+
+        uint32_t invocations = 0;   // Hotness counters driving the tier-up policy
+        uint32_t backEdges = 0;
+        Tier tier = Tier::INTERPRETED;
+        meow::runtime::FeedbackVector* feedback = nullptr;  // Allocated on the first recorded site, released with the proto
+        meow::jit::CompiledCode* compiled = nullptr;    // Machine code, released with the proto
+        meow::jit::LoopTraces* traces = nullptr;        // Hot loops and their traces, released with the proto
+        bool uncompilable = false;  // Compilation failed once, don't retry
+        ~ObjProto() override;
         void trace(meow::memory::GCVisitor& visitor) override;
     };
 
+    /**
+     * @struct ObjUpvalue
+     * @brief Represents a variable captured by reference
+     * @details While open, the upvalue points to a register on the stack and is linked in the
+     * open-upvalue list of MeowState, sorted by stack address from top to bottom.
+     * Closing it copies the register into the upvalue itself
+     */
+    struct ObjUpvalue : meow::memory::MeowObject {
+        Value* location;
+        Value closed;
+        ObjUpvalue* next = nullptr;
+
+        /**
+         * @brief Constructs an open upvalue
+         * @param[in] slot The stack slot of the captured register
+         */
+        explicit ObjUpvalue(Value* slot) : location(slot) {}
+
+        /**
+         * @brief Checks if the upvalue still refers to a stack slot
+         * @return 'true' if the upvalue is open, 'false' otherwise
+         */
+        bool isOpen() const noexcept {
+            return location != &closed;
+        }
+
+        /** @brief Moves the captured value off the stack into the upvalue */
+        void close() noexcept {
+            closed = *location;
+            location = &closed;
+        }
+
+        /**
+         * @brief Trace all reachable MeowObjects for Garbage Collector
+         * @param[in,out] visitor The Visitor that performs the tracing
+         * @see meow::memory::MeowObject::trace
+         */
+        void trace(meow::memory::GCVisitor& visitor) override {
+            visitor.visitValue(*location);
+        }
+    };
+
+    /**
+     * @struct ObjNative
+     * @brief Represents a host function callable from MeowScript
+     * @details The function reads its arguments in place from the caller's registers. Before calling it, the VM
+     * checks the argument count and the type of every argument against the declared signature, so the function
+     * can unbox them unchecked. Natives are made by the binding templates of runtime/native.h
+     */
+    struct ObjNative : meow::memory::MeowObject {
+        using Function = Value (*)(meow::memory::MemoryManager& heap, const Value* args);
+        static constexpr size_t MAX_PARAMS = 8;
+
+        std::string name;
+        Function function;
+        size_t arity;
+        uint32_t params[MAX_PARAMS] = {};   // Types each parameter accepts, one bit per alternative of Value
+
+        ObjNative(std::string nativeName, Function target, size_t count, const uint32_t* kinds)
+            : name(std::move(nativeName)), function(target), arity(count) {
+            std::copy_n(kinds, count, params);
+        }
+
+        /**
+         * @brief Native functions hold no traceable objects
+         * @param[in] visitor The visitor, unused
+         */
+        void trace([[maybe_unused]] meow::memory::GCVisitor& visitor) override {}
+    };
+
+    /**
+     * @struct ObjClosure
+     * @brief Represents a function with its captured variables in MeowScript
+     * @details The captured variables are stored inline, right after the object, in a single allocation.
+     * A captured slot holds the value itself when it's captured by value, or an Upvalue when it's captured by reference
+     */
     struct ObjClosure : meow::memory::MeowObject {
+        Proto proto;
+        size_t upvalueCount;
+
+        /**
+         * @brief Allocates a closure with room for its captured variables
+         * @param[in] size The size of ObjClosure
+         * @param[in] captures The number of captured variables
+         */
+        static void* operator new(std::size_t size, std::size_t captures) {
+            return ::operator new(size + captures * sizeof(Value));
+        }
+
+        static void operator delete(void* pointer) noexcept {
+            ::operator delete(pointer);
+        }
+
+        /**
+         * @brief Constructs a closure with every captured slot set to null
+         * @param[in] function The proto of the closure
+         * @warning Must be allocated with function->upvalues captured slots
+         */
+        explicit ObjClosure(Proto function);
 
+        ~ObjClosure() override {
+            std::destroy_n(upvalues(), upvalueCount);
+        }
+
+        /**
+         * @brief Gets the captured slots
+         * @return A pointer to the first captured slot
+         */
+        inline Value* upvalues() noexcept {
+            return reinterpret_cast<Value*>(this + 1);
+        }
+
+        /**
+         * @brief Reads a captured variable
+         * @param[in] index The index of the captured variable
+         * @return The read-only current value of the variable
+         * @warning No bound checking
+         */
+        inline const Value& getUpvalue(size_t index) noexcept {
+            Value& slot = upvalues()[index];
+            if (Upvalue* boxed = slot.get_if<Upvalue>()) {
+                return *(*boxed)->location;
+            }
+            return slot;
+        }
+
+        /**
+         * @brief Writes a captured variable
+         * @param[in] index The index of the captured variable
+         * @param[in] value The new value of the variable
+         * @warning No bound checking
+         */
+        inline void setUpvalue(size_t index, const Value& value) noexcept {
+            Value& slot = upvalues()[index];
+            if (Upvalue* boxed = slot.get_if<Upvalue>()) {
+                *(*boxed)->location = value;
+            } else {
+                slot = value;
+            }
+        }
+
+        /**
+         * @brief Trace all reachable MeowObjects for Garbage Collector
+         * @param[in,out] visitor The Visitor that performs the tracing
+         * @see meow::memory::MeowObject::trace
+         */
+        void trace(meow::memory::GCVisitor& visitor) override {
+            visitor.visitObject(proto);
+            Value* slots = upvalues();
+            for (size_t i = 0; i < upvalueCount; ++i) {
+                visitor.visitValue(slots[i]);
+            }
+        }
     };
 
-    struct CallFrame {
+    /**
+     * @struct ObjClass
+     * @brief Represents a class in MeowScript
+     * @details Calling a class makes an instance and runs its 'init' method on it, if it has one.
+     * Methods take the instance in their first register, an initializer returns it.
+     * The method table is flat: inheriting copies the superclass methods down, so a lookup costs one
+     * hash probe however deep the hierarchy is. Methods added to a superclass after a subclass named it
+     * bump the hierarchy epoch, and the subclass copies them down again on its next lookup
+     */
+    struct ObjClass : meow::memory::MeowObject {
+        std::string name;
+        Class superclass = nullptr;
+        std::unordered_map<std::string, Value> ownMethods;
+        std::unordered_map<std::string, Value> methods;     // Own and inherited
+        uint32_t version = 0;   // Bumped whenever the method table changes, inline caches check it
+        uint32_t flattenedEpoch = 0;    // The hierarchy epoch the inherited methods were copied at
+        bool hasSubclasses = false;
+
+        // Bumped when a class that was inherited from changes its methods, inline caches check it too
+        static inline uint32_t hierarchyEpoch = 0;
 
+        /**
+         * @brief Constructs a class without methods
+         * @param[in] className The name of the class
+         */
+        explicit ObjClass(std::string className) : name(std::move(className)) {}
+
+        /**
+         * @brief Looks a method up, inherited ones included
+         * @param[in] methodName The name of the method
+         * @return The read-only method, or nullptr if the class has none by that name
+         */
+        const Value* findMethod(const std::string& methodName) {
+            refresh();
+            auto it = methods.find(methodName);
+            return it != methods.end() ? &it->second : nullptr;
+        }
+
+        /**
+         * @brief Defines or replaces a method of the class
+         * @param[in] methodName The name of the method
+         * @param[in] method The method
+         */
+        void setMethod(const std::string& methodName, const Value& method) {
+            ownMethods[methodName] = method;
+            methods[methodName] = method;
+            ++version;
+            if (hasSubclasses) ++hierarchyEpoch;
+        }
+
+        /**
+         * @brief Makes the class a subclass of another one
+         * @details Copies the superclass methods the class doesn't define itself, replacing a previous superclass
+         * @param[in] parent The superclass
+         */
+        void inherit(Class parent) {
+            superclass = parent;
+            parent->hasSubclasses = true;
+            flatten();
+            if (hasSubclasses) ++hierarchyEpoch;
+        }
+
+        /** @brief Copies the inherited methods down again if a superclass changed since they were */
+        void refresh() {
+            if (superclass && flattenedEpoch != hierarchyEpoch) [[unlikely]] flatten();
+        }
+
+    private:
+        void flatten() {
+            superclass->refresh();
+            methods = superclass->methods;
+            for (const auto& [methodName, method] : ownMethods) {
+                methods[methodName] = method;
+            }
+            flattenedEpoch = hierarchyEpoch;
+            ++version;
+        }
+
+    public:
+        /**
+         * @brief Trace all reachable MeowObjects for Garbage Collector
+         * @param[in,out] visitor The Visitor that performs the tracing
+         * @see meow::memory::MeowObject::trace
+         */
+        void trace(meow::memory::GCVisitor& visitor) override {
+            visitor.visitObject(superclass);
+            for (auto& pair : ownMethods) {
+                visitor.visitValue(pair.second);
+            }
+            for (auto& pair : methods) {
+                visitor.visitValue(pair.second);
+            }
+        }
+    };
+
+    /**
+     * @struct ObjInstance
+     * @brief Represents an instance of a class in MeowScript
+     * @details Fields shadow methods of the same name
+     */
+    struct ObjInstance : meow::memory::MeowObject {
+        Class klass;
+        std::unordered_map<std::string, Value> fields;
+
+        /**
+         * @brief Constructs an instance without fields
+         * @param[in] instanceClass The class of the instance
+         */
+        explicit ObjInstance(Class instanceClass) : klass(instanceClass) {}
+
+        /**
+         * @brief Trace all reachable MeowObjects for Garbage Collector
+         * @param[in,out] visitor The Visitor that performs the tracing
+         * @see meow::memory::MeowObject::trace
+         */
+        void trace(meow::memory::GCVisitor& visitor) override {
+            visitor.visitObject(klass);
+            for (auto& pair : fields) {
+                visitor.visitValue(pair.second);
+            }
+        }
+    };
+
+    /**
+     * @struct ObjBoundMethod
+     * @brief Represents a method read off an instance, called with that instance as receiver
+     * @details Only reading a method as a value makes one, calls through INVOKE don't
+     */
+    struct ObjBoundMethod : meow::memory::MeowObject {
+        Value receiver;
+        Value method;
+
+        /**
+         * @brief Binds a method to a receiver
+         * @param[in] self The receiver
+         * @param[in] function The method
+         */
+        ObjBoundMethod(const Value& self, const Value& function) : receiver(self), method(function) {}
+
+        /**
+         * @brief Trace all reachable MeowObjects for Garbage Collector
+         * @param[in,out] visitor The Visitor that performs the tracing
+         * @see meow::memory::MeowObject::trace
+         */
+        void trace(meow::memory::GCVisitor& visitor) override {
+            visitor.visitValue(receiver);
+            visitor.visitValue(method);
+        }
+    };
+
+    /**
+     * @struct ObjStringBuilder
+     * @brief Represents a StringBuilder in MeowScript, a mutable buffer turned into a string once built
+     * @details Scripts call its methods through INVOKE: append(values...), toString(), size() and clear()
+     */
+    struct ObjStringBuilder : meow::memory::MeowObject {
+        std::string buffer;
+
+        /**
+         * @brief Trace all reachable MeowObjects for Garbage Collector
+         * @param[in,out] visitor The Visitor that performs the tracing
+         * @note This parameter is unused because ObjStringBuilder holds no traceable objects
+         * @see meow::memory::MeowObject::trace
+         */
+        void trace([[maybe_unused]] meow::memory::GCVisitor& visitor) override {}
+    };
+
+    /**
+     * @struct GlobalCell
+     * @brief A global variable slot of a module
+     * @details Cells are created when a name is first resolved, which may happen before the global is defined.
+     * A global defined later fills the same cell, so resolved slot indices never go stale.
+     * Counting assignments lets compiled code assume a global keeps its value and notice when it didn't
+     */
+    struct GlobalCell {
+        Value value;
+        bool defined = false;
+        uint32_t assignments = 0;
+
+        inline void assign(const Value& newValue) noexcept {
+            value = newValue;
+            defined = true;
+            ++assignments;
+        }
+    };
+
+    /**
+     * @struct ObjModule
+     * @brief Represents a module in MeowScript
+     * @details Owns the global variables of the module in an indexed slot array.
+     * Global names are resolved to slot indices once, when the module's code is linked.
+     * What other modules may read is published separately by \c EXPORT, in export slots that work the same way
+     */
+    struct ObjModule : meow::memory::MeowObject {
+    private:
+        std::string name;
+        std::string path;
+        std::vector<GlobalCell> cells;
+        std::vector<std::string> cellNames;
+        std::unordered_map<std::string, size_t> slots;
+        std::vector<GlobalCell> exportCells;
+        std::vector<std::string> exportNames;
+        std::unordered_map<std::string, size_t> exportSlots;
+        bool pending = false;   // Its body hasn't started running, so it has exported nothing yet
+    public:
+        /**
+         * @brief Constructs an empty module
+         * @param[in] moduleName The name of the module
+         * @param[in] filePath The canonical path of the file it's loaded from, empty for modules made by the host
+         */
+        ObjModule(const std::string& moduleName, std::string filePath = {}) : name(moduleName), path(std::move(filePath)) {}
+
+        /**
+         * @brief Gets the name of the module
+         * @return The read-only module name
+         */
+        const std::string& getName() const {
+            return name;
+        }
+
+        /**
+         * @brief Gets the path of the file the module is loaded from, imports in it are relative to its directory
+         * @return The read-only canonical path, empty for modules made by the host
+         */
+        const std::string& getPath() const {
+            return path;
+        }
+
+        /**
+         * @brief Checks if the body of the module has yet to run, a missing export may only be missing so far
+         * @return 'true' if the module is loaded from a file and its body hasn't started
+         */
+        bool isPending() const noexcept {
+            return pending;
+        }
+
+        void setPending(bool notStarted) noexcept {
+            pending = notStarted;
+        }
+
+        /**
+         * @brief Resolves an export name to its slot index
+         * @details Creates an undefined cell if nothing is exported under that name yet
+         * @param[in] exportName The exported name
+         * @return The slot index of the export
+         */
+        size_t resolveExport(const std::string& exportName) {
+            auto [it, inserted] = exportSlots.try_emplace(exportName, exportCells.size());
+            if (inserted) {
+                exportCells.emplace_back();
+                exportNames.push_back(exportName);
+            }
+            return it->second;
+        }
+
+        /**
+         * @brief Gets the export cell at specified slot index
+         * @param[in] slot The slot index of the export
+         * @return The mutable cell
+         * @warning No bound checking
+         */
+        GlobalCell& exportCell(size_t slot) {
+            return exportCells[slot];
+        }
+
+        /**
+         * @brief Gets the name of the export at specified slot index
+         * @param[in] slot The slot index of the export
+         * @return The read-only export name
+         * @warning No bound checking
+         */
+        const std::string& exportName(size_t slot) const {
+            return exportNames[slot];
+        }
+
+        /**
+         * @brief Gets the number of export slots
+         * @return Number of resolved exports, defined or not
+         */
+        size_t exportCount() const {
+            return exportCells.size();
+        }
+
+        /**
+         * @brief Publishes a value under a name
+         * @param[in] exportName The name importers read it with
+         * @param[in] value The value
+         */
+        void exportValue(const std::string& exportName, const Value& value) {
+            exportCells[resolveExport(exportName)].assign(value);
+        }
+
+        /**
+         * @brief Resolves a global name to its slot index
+         * @details Creates an undefined cell if the name isn't known yet
+         * @param[in] globalName The name of the global
+         * @return The slot index of the global
+         */
+        size_t resolveGlobal(const std::string& globalName) {
+            auto [it, inserted] = slots.try_emplace(globalName, cells.size());
+            if (inserted) {
+                cells.emplace_back();
+                cellNames.push_back(globalName);
+            }
+            return it->second;
+        }
+
+        /**
+         * @brief Gets the cell at specified slot index
+         * @param[in] slot The slot index of the global
+         * @return The mutable cell
+         * @warning No bound checking
+         */
+        GlobalCell& cell(size_t slot) {
+            return cells[slot];
+        }
+
+        /**
+         * @brief Gets the name of the global at specified slot index
+         * @param[in] slot The slot index of the global
+         * @return The read-only global name
+         * @warning No bound checking
+         */
+        const std::string& globalName(size_t slot) const {
+            return cellNames[slot];
+        }
+
+        /**
+         * @brief Defines or assigns a global by name
+         * @details Used by the host to define globals dynamically, linked code sees it through the same cell
+         * @param[in] globalName The name of the global
+         * @param[in] value The value to assign
+         */
+        void setGlobal(const std::string& globalName, const Value& value) {
+            cells[resolveGlobal(globalName)].assign(value);
+        }
+
+        /**
+         * @brief Gets the number of global slots
+         * @return Number of resolved globals, defined or not
+         */
+        size_t globalCount() const {
+            return cells.size();
+        }
+
+        /**
+         * @brief Trace all reachable MeowObjects for Garbage Collector
+         * @param[in,out] visitor The Visitor that performs the tracing
+         * @see meow::memory::MeowObject::trace
+         */
+        void trace(meow::memory::GCVisitor& visitor) override {
+            for (auto& cell : cells) {
+                visitor.visitValue(cell.value);
+            }
+            for (auto& cell : exportCells) {
+                visitor.visitValue(cell.value);
+            }
+        }
+    };
+
+    /**
+     * @struct CallFrame
+     * @brief Represents an active function call
+     * @details The registers of a frame are a window into MeowState::stackSlots starting at \c base.
+     * The caller places the callee in a register and the arguments right after it, so the arguments
+     * already are the first registers of the callee window and are never copied
+     */
+    struct CallFrame {
+        Proto proto;
+        Closure closure;            // The running closure, or nullptr when a bare proto is called
+        uint8_t* ip;                // Saved instruction pointer while the frame isn't running
+        size_t base;                // Index of register 0 in the stack slots
+        uint16_t returnRegister;    // Caller register receiving the result
     };
+
+    /**
+     * @brief Gets the heap object held by a value
+     * @param[in] value The value to inspect
+     * @return A pointer to the held object, or nullptr if the value holds a primitive
+     */
+    inline meow::memory::MeowObject* heapObject(const Value& value) noexcept {
+        return value.visit([](auto held) -> meow::memory::MeowObject* {
+            if constexpr (std::is_pointer_v<decltype(held)>) {
+                return held;
+            } else {
+                return nullptr;
+            }
+        });
+    }
 }
\ No newline at end of file
@@ -8,23 +8,88 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace meow::common {
     /**
      * @enum OpCode
      * @brief Represent all supported bytecode operation codes
+     * @details Every instruction is one opcode byte followed by its operands.
+     * Register, constant, argument count and jump target operands are 16-bit little-endian,
+     * the immediate of \c LOAD_INT is 64-bit little-endian. Jump targets are absolute offsets in the chunk
+     *
+     * \c TAIL_CALL fn, argc calls like CALL fn, fn, argc but a script function takes over the running frame.
+     * It is always followed by RETURN fn, which returns the result of the callees that can't take over
+     * the frame, such as natives
+     *
+     * \c INVOKE a, name, argc calls the method 'name' of the receiver in register a, with the argc arguments
+     * in the registers after it, and leaves the result in register a. The receiver is the method's first register.
+     * \c GET_SUPER dst, name replaces the superclass in register dst by its method 'name' bound to the receiver
+     * of the running method. \c SUPER_INVOKE a, name, argc calls that method without binding it: the superclass
+     * in register a is replaced by the receiver, and the call goes on like INVOKE
+     *
+     * \c ITER_PREP it, src starts walking the array or object in register src, using registers it to it + 2.
+     * \c ITER_NEXT it, dst, exit puts the next element, or the next value of an object, in register dst,
+     * or jumps to exit after the last one. \c ITER_KEY dst, it reads the index or key of that element
+     *
+     * \c FORPREP a, exit starts a counted loop from the integers start, limit and step in registers a to a + 2,
+     * the limit is exclusive. It jumps to exit if the loop doesn't run, otherwise puts start in the loop variable,
+     * register a + 3. \c FORLOOP a, body steps the loop variable and jumps back to body until the limit is reached
+     *
+     * \c IMPORT_MODULE dst, path loads the module file named by the string constant path once per VM and puts
+     * the module in register dst. The linker turns path into an import site of the proto. With lazy imports,
+     * the body of the module only runs when \c GET_EXPORT or \c IMPORT_ALL first needs it.
+     * \c EXPORT name, src publishes register src under name, \c GET_EXPORT dst, module, name reads an export
+     * of the module in register module, and \c IMPORT_ALL module defines every export as a global
+     *
+     * Quickened opcodes share the operand layout of the generic opcode they specialize,
+     * so the interpreter can rewrite the opcode byte in place without moving any code
      */
     enum class OpCode : unsigned char {
         LOAD_CONST, LOAD_NULL, LOAD_TRUE, LOAD_FALSE, LOAD_INT, MOVE,
         ADD, SUB, MUL, DIV, MOD, POW, EQ, NEQ, GT, GE, LT, LE,
         NEG, NOT,
         GET_GLOBAL, SET_GLOBAL, GET_UPVALUE, SET_UPVALUE, CLOSURE, CLOSE_UPVALUES,
-        JUMP, JUMP_IF_FALSE, JUMP_IF_TRUE, CALL, RETURN, HALT,
+        JUMP, JUMP_IF_FALSE, JUMP_IF_TRUE, CALL, TAIL_CALL, RETURN, HALT,
+        FORPREP, FORLOOP,
         NEW_ARRAY, NEW_HASH, GET_INDEX, SET_INDEX, GET_KEYS, GET_VALUES,
+        ITER_PREP, ITER_NEXT, ITER_KEY,
         NEW_CLASS, GET_PROP, SET_PROP,
-        SET_METHOD, INHERIT, GET_SUPER,
+        SET_METHOD, INHERIT, GET_SUPER, INVOKE, SUPER_INVOKE,
         BIT_AND, BIT_OR, BIT_XOR, BIT_NOT, LSHIFT, RSHIFT,
         THROW, SETUP_TRY, POP_TRY,
         IMPORT_MODULE, EXPORT, GET_EXPORT, IMPORT_ALL,
+        // Quickened forms, never emitted by the compiler
+        ADD_INT_INT, ADD_FLOAT_FLOAT, SUB_INT_INT, SUB_FLOAT_FLOAT, MUL_INT_INT, MUL_FLOAT_FLOAT,
+        LT_INT_INT, LT_FLOAT_FLOAT, EQ_INT_INT, GET_INDEX_ARRAY_INT,
         TOTAL_OPCODES
     };
-};
\ No newline at end of file
+
+    /**
+     * @brief Gets the size of an instruction
+     * @param[in] op The operation code of the instruction
+     * @return The number of bytes of the instruction, including the opcode byte
+     */
+    constexpr size_t instructionSize(OpCode op) noexcept {
+        switch (op) {
+            case OpCode::LOAD_NULL: case OpCode::LOAD_TRUE: case OpCode::LOAD_FALSE:
+            case OpCode::JUMP: case OpCode::RETURN: case OpCode::CLOSE_UPVALUES:
+            case OpCode::THROW: case OpCode::IMPORT_ALL:
+                return 3;
+            case OpCode::HALT: case OpCode::POP_TRY:
+                return 1;
+            case OpCode::LOAD_INT:
+                return 11;
+            case OpCode::LOAD_CONST: case OpCode::MOVE: case OpCode::NEG: case OpCode::NOT: case OpCode::BIT_NOT:
+            case OpCode::GET_GLOBAL: case OpCode::SET_GLOBAL: case OpCode::GET_UPVALUE: case OpCode::SET_UPVALUE:
+            case OpCode::CLOSURE: case OpCode::JUMP_IF_FALSE: case OpCode::JUMP_IF_TRUE:
+            case OpCode::GET_KEYS: case OpCode::GET_VALUES: case OpCode::NEW_CLASS: case OpCode::INHERIT:
+            case OpCode::GET_SUPER: case OpCode::SETUP_TRY: case OpCode::IMPORT_MODULE: case OpCode::EXPORT:
+            case OpCode::ITER_PREP: case OpCode::ITER_KEY: case OpCode::FORPREP: case OpCode::FORLOOP:
+            case OpCode::TAIL_CALL:
+                return 5;
+            default:
+                return 7;
+        }
+    }
+}
@@ -13,11 +13,19 @@
 namespace meow::common {
     // Forward declarations for heap-allocated objects
     struct ObjBytes;
+    struct ObjBigInt;
     struct ObjString;
     struct ObjArray;
     struct ObjHash;
     struct ObjModule;
     struct ObjProto;
+    struct ObjClosure;
+    struct ObjUpvalue;
+    struct ObjNative;
+    struct ObjClass;
+    struct ObjInstance;
+    struct ObjBoundMethod;
+    struct ObjStringBuilder;
 
     /**
      * @name Primitive value types
@@ -32,11 +40,19 @@ namespace meow::common {
      * @note All managed by GC
      */
     using Bytes = ObjBytes*;
+    using BigInt = ObjBigInt*;
     using String = ObjString*;
     using Array = ObjArray*;
     using Object = ObjHash*;
     using Module = ObjModule*;
     using Proto = ObjProto*;
+    using Closure = ObjClosure*;
+    using Upvalue = ObjUpvalue*;
+    using Native = ObjNative*;
+    using Class = ObjClass*;
+    using Instance = ObjInstance*;
+    using BoundMethod = ObjBoundMethod*;
+    using StringBuilder = ObjStringBuilder*;
 
     /**
      * @brief Union for all supported types
@@ -46,12 +62,20 @@ namespace meow::common {
         Int,
         Float,
         Bool,
+        BigInt,
         Bytes,
         String,
         Array,
         Object,
         Module,
-        Proto
+        Proto,
+        Closure,
+        Upvalue,
+        Native,
+        Class,
+        Instance,
+        BoundMethod,
+        StringBuilder
     >;
 
     /**
@@ -160,6 +184,7 @@ namespace meow::common {
         /**
          * @brief Casts value to int64_t
          * @return Casted integer value. What do you want more?
+         * @warning Raises RuntimeError for a BigInt, which doesn't fit
          */
         int64_t asInt() const;
 
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file assembler.h
+ * @author lazypaws
+ * @brief Defines the x86-64 assembler shared by the MeowScript machine code generators
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "jit/jit_helpers.h"
+#include "common/pch.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define MEOW_JIT_X86_64 1
+#endif
+
+#ifdef MEOW_JIT_X86_64
+namespace meow::jit {
+    enum Register : uint8_t {
+        RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+        R8 = 8, R9 = 9, R10 = 10, R11 = 11, R12 = 12, R13 = 13, R14 = 14, R15 = 15
+    };
+
+    /**
+     * @class Assembler
+     * @brief Just enough of an x86-64 assembler for the baseline templates and traces
+     * @details Operands are encoded as the code generators need them, there is no instruction selection
+     */
+    class Assembler {
+    public:
+        std::vector<uint8_t> bytes;
+
+        inline size_t here() const noexcept {
+            return bytes.size();
+        }
+
+        void byte(uint8_t value) {
+            bytes.push_back(value);
+        }
+
+        void imm32(uint32_t value) {
+            for (int i = 0; i < 4; ++i) byte(static_cast<uint8_t>(value >> (i * 8)));
+        }
+
+        void imm64(uint64_t value) {
+            for (int i = 0; i < 8; ++i) byte(static_cast<uint8_t>(value >> (i * 8)));
+        }
+
+        // Emits a rel32 branch and returns the offset of its displacement for patching
+        size_t branch(std::initializer_list<uint8_t> opcode) {
+            for (uint8_t value : opcode) byte(value);
+            imm32(0);
+            return here() - 4;
+        }
+
+        // The opcode, then a ModRM byte addressing [base + displacement] with 'reg' in its reg field
+        void memory(std::initializer_list<uint8_t> opcode, uint8_t reg, Register base, int32_t displacement) {
+            for (uint8_t value : opcode) byte(value);
+            byte(static_cast<uint8_t>(0x80 | (reg << 3) | base));
+            imm32(static_cast<uint32_t>(displacement));
+        }
+
+        // Like memory(), for any of the 16 registers: the mandatory prefix (0 for none), REX, then the opcode
+        void indirect(uint8_t prefix, bool wide, std::initializer_list<uint8_t> opcode, uint8_t reg, Register base, int32_t displacement) {
+            rex(prefix, wide, opcode, reg, base);
+            byte(static_cast<uint8_t>(0x80 | ((reg & 7) << 3) | (base & 7)));
+            if ((base & 7) == RSP) byte(0x24);              // rsp and r12 can only be a base through a SIB byte
+            imm32(static_cast<uint32_t>(displacement));
+        }
+
+        // The same with the register 'rm' as the other operand
+        void direct(uint8_t prefix, bool wide, std::initializer_list<uint8_t> opcode, uint8_t reg, uint8_t rm) {
+            rex(prefix, wide, opcode, reg, rm);
+            byte(static_cast<uint8_t>(0xC0 | ((reg & 7) << 3) | (rm & 7)));
+        }
+
+        // mov dst, value
+        void load(Register dst, uint64_t value) {
+            byte(static_cast<uint8_t>(0x48 | (dst >> 3)));
+            byte(static_cast<uint8_t>(0xB8 | (dst & 7)));
+            imm64(value);
+        }
+
+        void patch(size_t at, size_t target) {
+            uint32_t displacement = static_cast<uint32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(at + 4));
+            for (int i = 0; i < 4; ++i) bytes[at + i] = static_cast<uint8_t>(displacement >> (i * 8));
+        }
+
+        // helper(rbx, pc, a, b, c), result in eax
+        void call(Helper helper, uint32_t pc, uint32_t a, uint32_t b, uint32_t c) {
+            byte(0x48); byte(0x89); byte(0xDF);             // mov rdi, rbx
+            byte(0xBE); imm32(pc);                          // mov esi, pc
+            byte(0xBA); imm32(a);                           // mov edx, a
+            byte(0xB9); imm32(b);                           // mov ecx, b
+            byte(0x41); byte(0xB8); imm32(c);               // mov r8d, c
+            byte(0x48); byte(0xB8);                         // mov rax, helper
+            imm64(reinterpret_cast<uint64_t>(helper));
+            byte(0xFF); byte(0xD0);                         // call rax
+            byte(0x85); byte(0xC0);                         // test eax, eax
+        }
+    private:
+        void rex(uint8_t prefix, bool wide, std::initializer_list<uint8_t> opcode, uint8_t reg, uint8_t rm) {
+            if (prefix) byte(prefix);
+            uint8_t rex = static_cast<uint8_t>(0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm >> 3));
+            if (rex != 0x40) byte(rex);
+            for (uint8_t value : opcode) byte(value);
+        }
+    };
+}
+#endif
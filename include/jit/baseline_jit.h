@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file baseline_jit.h
+ * @author lazypaws
+ * @brief Defines the baseline template JIT of MeowScript
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "jit/compiled_code.h"
+#include "jit/code_memory.h"
+
+namespace meow::jit {
+    /**
+     * @class NativeCode
+     * @brief Machine code with one template per instruction
+     * @details Moves, loads and integer arithmetic and comparisons are emitted inline, guarded on their operands
+     * being Ints and on overflow. A failed guard, and every other instruction, calls the instruction's helper
+     */
+    class NativeCode : public CompiledCode {
+    public:
+        static constexpr uint32_t NO_ENTRY = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * @brief Installs compiled machine code
+         * @param[in] code The machine code
+         * @param[in] entries The native offset of every instruction, indexed by bytecode offset, NO_ENTRY inside instructions
+         */
+        NativeCode(const std::vector<uint8_t>& code, std::vector<uint32_t> entries);
+
+        inline bool hasEntry(size_t pc) const noexcept override {
+            return pc < entries.size() && entries[pc] != NO_ENTRY;
+        }
+
+        size_t run(JitContext& context, size_t pc) const noexcept override;
+    private:
+        CodeBlock block;
+        std::vector<uint32_t> entries;
+    };
+
+    /**
+     * @brief Checks if this build can generate machine code for the host
+     * @return 'true' on x86-64 System V hosts, 'false' otherwise
+     */
+    bool isSupported() noexcept;
+
+    /**
+     * @brief Compiles a proto with one machine code template per instruction
+     * @param[in] proto The linked proto to compile
+     * @return The machine code, or nullptr if the host isn't supported
+     */
+    std::unique_ptr<CompiledCode> compileBaseline(const meow::common::ObjProto& proto);
+}
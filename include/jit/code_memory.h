@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file code_memory.h
+ * @author lazypaws
+ * @brief Defines executable memory for MeowScript JIT compilers
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/pch.h"
+
+namespace meow::jit {
+    /**
+     * @class CodeBlock
+     * @brief A block of machine code that is either writable or executable, never both (W^X)
+     * @details The block is mapped read-write while code is copied in, then sealed read-execute.
+     * A sealed block can't be written again, recompiling means allocating a new block
+     */
+    class CodeBlock {
+    public:
+        /**
+         * @brief Maps a writable block holding a copy of the code and seals it executable
+         * @param[in] code The machine code to install
+         * @warning Raises std::bad_alloc if the pages can't be mapped or sealed
+         */
+        explicit CodeBlock(const std::vector<uint8_t>& code);
+        ~CodeBlock();
+
+        CodeBlock(const CodeBlock&) = delete;
+        CodeBlock& operator=(const CodeBlock&) = delete;
+
+        /**
+         * @brief Gets the address of the first instruction
+         * @return A pointer to the executable code
+         */
+        inline const uint8_t* data() const noexcept {
+            return memory;
+        }
+
+        /**
+         * @brief Gets the size of the installed code
+         * @return Number of bytes of machine code
+         */
+        inline size_t size() const noexcept {
+            return codeSize;
+        }
+    private:
+        uint8_t* memory;
+        size_t codeSize;
+        size_t mappedSize;
+    };
+}
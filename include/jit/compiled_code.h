@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file compiled_code.h
+ * @author lazypaws
+ * @brief Defines the interface between the interpreter and compiled MeowScript code
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/definitions.h"
+#include "common/pch.h"
+
+#include <exception>
+
+namespace meow::memory {
+    class MemoryManager;
+}
+
+namespace meow::jit {
+    // A proto is compiled once it has been called, or has jumped backwards, this many times
+    constexpr uint32_t INVOCATION_THRESHOLD = 1000;
+    constexpr uint32_t BACK_EDGE_THRESHOLD = 10000;
+
+    /**
+     * @struct JitContext
+     * @brief The state of the interpreter frame that compiled code runs in
+     * @details Errors raised inside compiled code are parked in 'pending' and rethrown by the interpreter
+     * at the instruction that raised them
+     */
+    struct JitContext {
+        meow::common::Value* regs;
+        const meow::common::Value* constants;
+        meow::common::Module globals;
+        meow::common::Closure closure;
+        meow::memory::MemoryManager* heap;
+        std::exception_ptr pending;
+    };
+
+    /**
+     * @class CompiledCode
+     * @brief Compiled code of a whole proto, enterable at any instruction boundary
+     * @details The code runs the frame until it reaches an instruction it leaves to the interpreter
+     * (calls, returns, throws, allocation of closures...) or an error, then returns that instruction's offset
+     */
+    class CompiledCode {
+    public:
+        virtual ~CompiledCode() = default;
+
+        /**
+         * @brief Checks if the code can be entered at an instruction
+         * @param[in] pc The bytecode offset of the instruction
+         * @return 'true' if an instruction starts at the offset, 'false' otherwise
+         */
+        virtual bool hasEntry(size_t pc) const noexcept = 0;
+
+        /**
+         * @brief Runs the frame from an instruction until the code exits
+         * @param[in, out] context The frame state, 'pending' is set if an error was raised
+         * @param[in] pc The bytecode offset to start at, must have an entry
+         * @return The bytecode offset the interpreter resumes at
+         */
+        virtual size_t run(JitContext& context, size_t pc) const noexcept = 0;
+    };
+
+    /**
+     * @enum Backend
+     * @brief The code generators a proto can be compiled with
+     */
+    enum class Backend {
+        NATIVE,     // x86-64 machine code templates
+        THREADED    // Portable pre-decoded handler sequences
+    };
+
+    /**
+     * @brief Picks the fastest backend the host supports
+     * @return NATIVE where machine code can be generated, THREADED otherwise
+     */
+    Backend defaultBackend() noexcept;
+
+    /**
+     * @brief Compiles a proto
+     * @param[in] proto The linked proto to compile
+     * @param[in] backend The code generator to use
+     * @return The compiled code, or nullptr if the backend doesn't support the host
+     */
+    std::unique_ptr<CompiledCode> compile(const meow::common::ObjProto& proto, Backend backend);
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file deopt.h
+ * @author lazypaws
+ * @brief Defines how speculative code bails out to the interpreter
+ * @details Quickened instructions, traces and compiled code all speculate on what they saw so far.
+ * When that turns out wrong they hand the frame back to the interpreter, count the failure against
+ * the bytecode site that speculated, and stop speculating at sites that keep failing
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/definitions.h"
+#include "common/pch.h"
+
+namespace meow::jit {
+    // A site is no longer speculated on once its speculation failed this many times
+    constexpr uint32_t MAX_SITE_DEOPTS = 2;
+    // A trace is thrown away after this many runs in a row that left it before the loop went around
+    constexpr uint32_t MAX_EARLY_EXITS = 16;
+
+    using IrRef = uint32_t;
+
+    /**
+     * @struct Snapshot
+     * @brief The interpreter state to restore when leaving optimized code
+     * @details Maps optimized values back to the registers of the CallFrame, the frame resumes at 'pc'.
+     * Registers not listed already hold the right value. 'temporaries' are the registers written later on
+     * in the loop body, which only hold an optimized value once the loop went around
+     */
+    struct Snapshot {
+        uint32_t pc;
+        std::vector<std::pair<uint16_t, IrRef>> registers;
+        std::vector<std::pair<uint16_t, IrRef>> temporaries;
+    };
+
+    /**
+     * @struct GlobalAssumption
+     * @brief Optimized code relies on a global keeping the value it had when the code was made
+     * @details Nothing is patched when the global is assigned, the code checks its assumptions
+     * before it runs again and is thrown away if one broke (lazy deoptimization)
+     */
+    struct GlobalAssumption {
+        uint32_t pc;            // The instruction that read the global
+        uint32_t slot;
+        uint32_t assignments;   // Of the cell when the assumption was made
+
+        inline bool holds(meow::common::Module globals) const noexcept {
+            return globals->cell(slot).assignments == assignments;
+        }
+    };
+
+    /**
+     * @brief Checks if a site may still be speculated on
+     * @param[in] proto The proto the site belongs to
+     * @param[in] pc The bytecode offset of the site
+     * @return 'false' if speculation failed there too often
+     */
+    bool maySpeculate(const meow::common::ObjProto& proto, uint32_t pc) noexcept;
+
+    /**
+     * @brief Counts a failed speculation against a site
+     * @param[in, out] proto The proto the site belongs to, its feedback is allocated if needed
+     * @param[in] pc The bytecode offset of the site
+     */
+    void recordDeopt(meow::common::ObjProto& proto, uint32_t pc);
+}
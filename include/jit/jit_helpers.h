@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file jit_helpers.h
+ * @author lazypaws
+ * @brief Defines the instruction helpers shared by the MeowScript JIT backends
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/op_codes.h"
+#include "jit/compiled_code.h"
+
+namespace meow::jit {
+    /*
+     * Every instruction compiled code runs in place goes through a helper with the signature
+     *   uint32_t helper(JitContext*, uint32_t pc, uint32_t a, uint32_t b, uint32_t c)
+     * returning 0 to fall through to the next instruction, or pc + 1 to exit to the interpreter.
+     * Helpers never throw, native code has no unwind tables to throw through
+     */
+    using Helper = uint32_t (*)(JitContext*, uint32_t, uint32_t, uint32_t, uint32_t);
+
+    /**
+     * @brief Gets the helper running an instruction inside compiled code
+     * @param[in] op The opcode of the instruction
+     * @return The helper, or nullptr if the instruction exits to the interpreter
+     */
+    Helper helperFor(meow::common::OpCode op) noexcept;
+
+    /**
+     * @brief The helper of conditional jumps, returning the truth value of register 'cond' instead of an exit status
+     */
+    uint32_t truthy(JitContext* context, uint32_t pc, uint32_t cond, uint32_t, uint32_t) noexcept;
+
+    /**
+     * @brief The helper of FORLOOP, stepping the loop in register 'a' and returning 1 if it jumps back to the body
+     */
+    uint32_t forLoop(JitContext* context, uint32_t pc, uint32_t a, uint32_t, uint32_t) noexcept;
+
+    /**
+     * @brief Decodes the operands of an instruction into helper arguments
+     * @param[in] code The bytecode
+     * @param[in] pc The offset of the instruction
+     * @param[out] operands The 'a', 'b' and 'c' helper arguments, LOAD_INT splits its immediate over 'b' and 'c'
+     */
+    void decodeOperands(const uint8_t* code, size_t pc, uint32_t (&operands)[3]) noexcept;
+}
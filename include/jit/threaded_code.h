@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file threaded_code.h
+ * @author lazypaws
+ * @brief Defines the portable threaded-code backend of the MeowScript JIT
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "jit/compiled_code.h"
+#include "jit/jit_helpers.h"
+
+namespace meow::jit {
+    /**
+     * @class ThreadedCode
+     * @brief A proto compiled into a sequence of pre-decoded steps
+     * @details Pre-decoded threaded dispatch over the shared helpers: each step holds a pointer to its instruction's
+     * helper, the decoded operands and the step a jump continues at. run() switches on the kind of each step and
+     * calls the helper, so opcodes and operands aren't decoded again, but no code is generated. Works on any host
+     */
+    class ThreadedCode : public CompiledCode {
+    public:
+        static constexpr uint32_t NO_ENTRY = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * @enum Kind
+         * @brief What a step does besides calling its helper
+         */
+        enum class Kind : uint8_t {
+            HELPER,         // Calls the helper, exits if it returns non-zero
+            JUMP,           // Continues at 'target'
+            JUMP_IF_FALSE,  // Continues at 'target' if register 'operands[0]' is falsy
+            JUMP_IF_TRUE,   // Continues at 'target' if register 'operands[0]' is truthy
+            FOR_LOOP,       // Steps the counted loop in register 'operands[0]', continues at 'target' if it runs again
+            EXIT            // Resumes the interpreter at 'pc'
+        };
+
+        struct Step {
+            Kind kind;
+            Helper helper;
+            uint32_t pc;
+            uint32_t operands[3];
+            uint32_t target;    // Index of the step jumped to
+        };
+
+        /**
+         * @brief Installs compiled steps
+         * @param[in] steps The steps, ending with an EXIT
+         * @param[in] entries The step of every instruction, indexed by bytecode offset, NO_ENTRY inside instructions
+         */
+        ThreadedCode(std::vector<Step> steps, std::vector<uint32_t> entries);
+
+        inline bool hasEntry(size_t pc) const noexcept override {
+            return pc < entries.size() && entries[pc] != NO_ENTRY;
+        }
+
+        size_t run(JitContext& context, size_t pc) const noexcept override;
+    private:
+        std::vector<Step> steps;
+        std::vector<uint32_t> entries;
+    };
+
+    /**
+     * @brief Compiles a proto into threaded code
+     * @param[in] proto The linked proto to compile
+     * @return The threaded code
+     */
+    std::unique_ptr<CompiledCode> compileThreaded(const meow::common::ObjProto& proto);
+}
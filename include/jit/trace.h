@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file trace.h
+ * @author lazypaws
+ * @brief Defines traces of hot loops and their SSA IR
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "jit/code_memory.h"
+#include "jit/compiled_code.h"
+#include "jit/deopt.h"
+#include "common/pch.h"
+
+namespace meow::jit {
+    // A loop is recorded once its back-edge has been taken this many times
+    constexpr uint32_t HOT_LOOP_THRESHOLD = 64;
+    // Loops whose recording failed, or whose traces were thrown away, this many times are left to the interpreter
+    constexpr uint32_t MAX_TRACE_ABORTS = 4;
+
+    /**
+     * @enum IrType
+     * @brief The unboxed type of an IR value
+     */
+    enum class IrType : uint8_t {
+        INT, FLOAT, BOOL, ARRAY, NONE
+    };
+
+    /**
+     * @enum IrOp
+     * @brief Operations of the trace IR
+     * @details Operations marked as guards leave the trace through their snapshot when they fail
+     */
+    enum class IrOp : uint8_t {
+        LOAD,           // Unboxes register 'a' at trace entry, guards its type
+        GLOBAL,         // Unboxes global slot 'imm', guards that it's defined and its type
+        CONST,          // The immediate 'imm', globals assumed not to change are folded into one
+        PHI,            // Loop-carried value: 'a' on entry, 'b' from the previous iteration
+        TO_FLOAT,       // Converts integer 'a'
+        ADD, SUB, MUL,  // Integer forms guard overflow
+        DIV,
+        NEG,            // Integer form guards overflow
+        LT, LE, EQ, NE, // Compare 'a' and 'b' of type 'operand'
+        NOT,            // Negated truth of 'a'
+        GUARD_TRUE,     // Guards that 'a' is truthy
+        GUARD_FALSE,    // Guards that 'a' is falsy
+        ARRAY_GET,      // Element 'b' of array 'a', guards the bounds and the element type
+        ARRAY_SET       // Stores 'c' in element 'b' of array 'a', guards the bounds
+    };
+
+    constexpr IrRef NO_REF = std::numeric_limits<IrRef>::max();
+
+    /**
+     * @struct IrInstr
+     * @brief One SSA instruction, its result is referred to by its index
+     */
+    struct IrInstr {
+        IrOp op;
+        IrType type = IrType::NONE;     // Type of the result
+        IrType operand = IrType::NONE;  // Type of the compared operands
+        IrRef a = NO_REF;
+        IrRef b = NO_REF;
+        IrRef c = NO_REF;
+        int64_t imm = 0;                // Register or global slot, or the bits of a constant
+        uint32_t snapshot = 0;          // Exit taken when a guard fails
+        uint32_t slot = 0;              // Where the executor keeps the result
+        uint32_t operandSlots[3] = {};  // Slots of 'a', 'b' and 'c', so the executor reads them directly
+    };
+
+    /**
+     * @union Slot
+     * @brief An unboxed value as traces keep it
+     * @details Machine code tests and compares booleans as whole words, so it keeps them zero-extended
+     */
+    union Slot {
+        int64_t i;
+        double f;
+        bool b;
+        meow::common::ObjArray* array;
+    };
+
+    inline bool unbox(const meow::common::Value& value, IrType type, Slot& slot) noexcept {
+        using namespace meow::common;
+        switch (type) {
+            case IrType::INT: if (!value.is<Int>()) return false; slot.i = value.get<Int>(); return true;
+            case IrType::FLOAT: if (!value.is<Float>()) return false; slot.f = value.get<Float>(); return true;
+            case IrType::BOOL: if (!value.is<Bool>()) return false; slot.i = value.get<Bool>(); return true;
+            case IrType::ARRAY: if (!value.is<Array>()) return false; slot.array = value.get<Array>(); return true;
+            default: return false;
+        }
+    }
+
+    inline meow::common::Value box(const Slot& slot, IrType type) noexcept {
+        using namespace meow::common;
+        switch (type) {
+            case IrType::INT: return static_cast<Int>(slot.i);
+            case IrType::FLOAT: return static_cast<Float>(slot.f);
+            case IrType::BOOL: return slot.b;
+            case IrType::ARRAY: return Array(slot.array);
+            default: return Null{};
+        }
+    }
+
+    /**
+     * @class Trace
+     * @brief One recorded iteration of a loop, optimized and run on unboxed values
+     * @details The code is a preamble run once on entry, the phis, then the loop body.
+     * Snapshot 0 resumes at the loop header without touching any register, guards hoisted into the preamble use it.
+     * A trace must not run once one of its assumptions broke. It runs as machine code where the host supports it,
+     * on the IR executor otherwise
+     */
+    class Trace {
+    public:
+        uint32_t header;
+        std::vector<IrInstr> code;
+        size_t loopStart = 0;                                   // First phi, the body follows the phis
+        size_t bodyStart = 0;
+        std::vector<Snapshot> snapshots;
+        std::vector<GlobalAssumption> assumptions;
+        std::vector<std::pair<uint32_t, uint32_t>> backEdgeMoves;  // (phi slot, slot of the carried value)
+        size_t slotCount = 0;       // Machine code uses two more, see compileTrace()
+        uint32_t earlyExits = 0;    // Runs in a row that exited before the loop went around
+        std::unique_ptr<CodeBlock> machineCode;
+
+        /**
+         * @brief Finds an assumption that no longer holds
+         * @param[in] globals The module the trace reads globals from
+         * @return The broken assumption, or nullptr if the trace can run
+         */
+        const GlobalAssumption* brokenAssumption(meow::common::Module globals) const noexcept;
+
+        /**
+         * @brief Runs the loop from its header until a guard fails
+         * @param[in, out] context The frame state
+         * @return The bytecode offset the interpreter resumes at
+         */
+        size_t run(JitContext& context) noexcept;
+
+        /**
+         * @brief Formats the IR for debugging
+         * @return One line per instruction
+         */
+        std::string dump() const;
+    private:
+        /**
+         * @brief Runs the IR until a guard fails
+         * @param[in, out] context The frame state
+         * @param[in, out] slots The slots of the trace
+         * @param[out] iterated Set if the loop went around
+         * @return The index of the instruction whose guard failed
+         */
+        size_t execute(JitContext& context, Slot* slots, bool& iterated) const noexcept;
+    };
+
+    /**
+     * @struct LoopTraces
+     * @brief Hotness and traces of the loops of one proto, keyed by loop header
+     */
+    struct LoopTraces {
+        struct Loop {
+            uint32_t hits = 0;
+            uint32_t aborts = 0;
+            bool blacklisted = false;
+            std::unique_ptr<Trace> trace;
+        };
+        std::unordered_map<uint32_t, Loop> loops;
+    };
+
+    /**
+     * @brief Runs one iteration of a loop through the instruction helpers while recording it
+     * @param[in, out] context The frame state
+     * @param[in] proto The proto the loop belongs to
+     * @param[in] header The bytecode offset of the loop header
+     * @param[out] resumePc Where the interpreter continues, the header if the iteration completed
+     * @return The optimized trace, or nullptr if the path can't be traced. 'pending' is set if an error was raised
+     */
+    std::unique_ptr<Trace> recordTrace(JitContext& context, const meow::common::ObjProto& proto, uint32_t header, size_t& resumePc);
+
+    /**
+     * @brief Optimizes a recorded trace and assigns executor slots
+     * @details Folds constants, removes redundant guards and common subexpressions,
+     * hoists loop invariants into the preamble and drops dead code
+     * @param[in, out] trace The trace, in recording order with its phis last
+     * @return 'false' if a guard always fails, so the trace is useless
+     */
+    bool optimizeTrace(Trace& trace);
+
+    /**
+     * @brief Generates machine code for an optimized trace
+     * @details The slots the loop uses most live in callee-saved registers, the rest stay in memory. The code is
+     * called with the context and the slots, plus two past 'slotCount': one breaking cycles of back-edge moves,
+     * then one set once the loop went around. A failed guard writes the registers back to their slots and returns
+     * the index of its instruction, so leaving the trace works the same as from the IR executor
+     * @param[in] trace The optimized trace
+     * @return The machine code, or nullptr if the host isn't supported or the trace uses an operation left to the executor
+     * @warning Raises std::bad_alloc if the code can't be mapped
+     */
+    std::unique_ptr<CodeBlock> compileTrace(const Trace& trace);
+}
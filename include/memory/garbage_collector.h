@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace meow::runtime { 
     struct MeowState;
 }
@@ -34,7 +36,8 @@ namespace meow::memory {
         /**
          * @brief Runs a garbage collection cycle to free unused objects
          * @param[in] state The current MeowVM state, used to identify root objects for marking
+         * @return The number of objects that survived the cycle
          */
-        virtual void collect(meow::runtime::MeowState& state) = 0;
+        virtual size_t collect(meow::runtime::MeowState& state) = 0;
     };
 }
\ No newline at end of file
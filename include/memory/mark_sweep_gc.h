@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file mark_sweep_gc.h
+ * @author lazypaws
+ * @brief Defines the mark-and-sweep Garbage Collector for MeowScript
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/pch.h"
+#include "common/value.h"
+#include "memory/garbage_collector.h"
+#include "memory/gc_visitor.h"
+
+namespace meow::memory {
+    /**
+     * @class MarkSweepGC
+     * @brief A stop-the-world, non-moving mark-and-sweep collector
+     */
+    class MarkSweepGC : public GarbageCollector, public GCVisitor {
+    public:
+        ~MarkSweepGC() override;
+
+        void registerObject(MeowObject* object) override;
+        size_t collect(meow::runtime::MeowState& state) override;
+
+        void visitValue(meow::common::Value& value) override;
+        void visitObject(MeowObject* object) override;
+    private:
+        std::vector<MeowObject*> objects;
+        std::vector<MeowObject*> grayStack;
+    };
+}
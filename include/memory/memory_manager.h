@@ -6,6 +6,8 @@
 
 namespace meow::memory {
     struct MemoryManager {
+        // Collections never run closer together than this many allocations
+        static constexpr size_t MIN_THRESHOLD = 1024;
     private:
         std::unique_ptr<GarbageCollector> gc;
         size_t allocated;
@@ -17,7 +19,7 @@ namespace meow::memory {
         template <typename T, typename ... Args>
         T* newObject(Args&& ... args) {
             if (allocated >= threshold) {
-                gc->collect()
+                collect();
             }
             T* newObject = new T(std::forward<Args>(args)...);
             gc->registerObject(static_cast<MeowObject*>(newObject));
@@ -25,9 +27,27 @@ namespace meow::memory {
             return newObject;
         }
 
+        /**
+         * @brief Allocates an object followed by inline trailing storage
+         * @details T must provide a class-specific placement operator new taking the trailing element count
+         */
+        template <typename T, typename ... Args>
+        T* newTrailingObject(size_t trailing, Args&& ... args) {
+            if (allocated >= threshold) {
+                collect();
+            }
+            T* newObject = new (trailing) T(std::forward<Args>(args)...);
+            gc->registerObject(static_cast<MeowObject*>(newObject));
+            ++allocated;
+            return newObject;
+        }
+
+        // The next collection waits for twice as many allocations as objects survived this one,
+        // so marking the live heap costs a constant amount per allocation however large it grows
         inline void collect() {
             if (!state) return;
-            gc->collect(*state);
+            size_t survivors = gc->collect(*state);
+            threshold = std::max(MIN_THRESHOLD, 2 * survivors);
             allocated = 0;
         }
 
@@ -4,7 +4,9 @@ namespace meow::memory {
     struct GCVisitor;
 
     struct MeowObject {
+        bool marked = false;
+
         virtual ~MeowObject() = default;
         virtual void trace(GCVisitor&) = 0;
     };
-};
\ No newline at end of file
+};
@@ -1,15 +1,64 @@
 #pragma once
 
+#include "common/definitions.h"
+#include "memory/memory_manager.h"
 #include "runtime/meow_state.h"
+#include "jit/compiled_code.h"
+#include "runtime/native.h"
+#include "runtime/module/module_manager.h"
 
 namespace meow::vm {
     class MeowVM {
     public:
         MeowVM(const std::string& entry, int argc, char** argv);
         void interpret(const std::string& entryPath);
+        meow::common::Value execute(meow::common::Proto proto);
+
+        // The JIT is on by default, MEOW_JIT=0 in the environment turns it off and MEOW_JIT=threaded picks the portable backend
+        void setJitEnabled(bool enabled) noexcept;
+        void setJitBackend(meow::jit::Backend backend) noexcept;
+
+        // Off by default, MEOW_LAZY_IMPORTS=1 turns it on: IMPORT_MODULE only finds the file,
+        // the module is compiled and run when GET_EXPORT or IMPORT_ALL first needs it
+        void setLazyImports(bool enabled) noexcept;
+
+        // Binds a host function as a global of a module, see runtime/native.h for the supported signatures
+        template <auto F>
+        void defineNative(meow::common::Module module, const std::string& name) {
+            module->setGlobal(name, meow::runtime::makeNative<F>(*heap, name));
+        }
+
+        // Sets the front end turning module sources into protos, which interpret and IMPORT_MODULE load files with
+        void setCompiler(meow::runtime::module::ModuleManager::Compiler compiler);
+        // Same, split so interpret can parse the import graph on every core before running the entry module
+        void setFrontend(std::unique_ptr<meow::runtime::module::Frontend> frontend);
+
+        // Compiled module bodies are cached in MEOW_CACHE_DIR, or the user's cache directory, MEOW_CACHE=0 turns it off.
+        // An empty directory turns it off too, and so does a build that doesn't define MEOW_VM_BUILD
+        void setCacheDirectory(const std::filesystem::path& directory);
+
+        // Binds the StringBuilder constructor as a global of a module
+        void defineStringBuilder(meow::common::Module module);
     private:
+        meow::common::Value run(size_t entryDepth);
+        meow::common::Upvalue captureUpvalue(meow::common::Value* slot);
+        void closeUpvalues(meow::common::Value* last) noexcept;
+        void tierUp(meow::common::Proto proto) noexcept;
+        void compile(meow::common::Proto proto) noexcept;
+        void writeProfile(meow::common::Proto proto) const noexcept;
+        meow::common::Module importModule(meow::runtime::module::ModuleRecord& record);
+        void runModule(meow::runtime::module::ModuleRecord& record);
+        void forceModule(meow::common::Module module);
+
         std::string entryPointDir;
         std::vector<std::string> commandLineArgs;
         meow::runtime::MeowState state;
+        std::unique_ptr<meow::memory::MemoryManager> heap;
+        std::unique_ptr<meow::runtime::module::ModuleManager> modules;
+        bool jitEnabled;
+        meow::jit::Backend jitBackend;
+        bool lazyImports;
+        meow::common::Tier topTier;     // Protos below it are still moving up
+        std::string profilePath;    // From MEOW_PROFILE, receives the counters, tiers and feedback of top-level scripts
     };
 }
@@ -11,10 +11,15 @@ namespace meow::runtime {
         std::vector<meow::common::Value> constantPool;
         size_t ip;
     public:
-        void writeByte(uint8_t byte) { 
+        void writeByte(uint8_t byte) {
             code.push_back(byte);
         }
 
+        void writeShort(uint16_t value) {
+            code.push_back(static_cast<uint8_t>(value & 0xff));
+            code.push_back(static_cast<uint8_t>((value >> 8) & 0xff));
+        }
+
         void writeInt64(int64_t value) {
             for (int i = 0; i < 8; ++i) {
                 code.push_back(static_cast<uint8_t>((value >> (i * 8)) & 0xff));
@@ -25,6 +30,12 @@ namespace meow::runtime {
             return code[ip++];
         }
 
+        uint16_t readShort() {
+            uint16_t value = static_cast<uint16_t>(code[ip] | (code[ip + 1] << 8));
+            ip += 2;
+            return value;
+        }
+
         int64_t readInt64() {
             int64_t value = 0;
             for (int i = 0; i < 8; i++) {
@@ -33,10 +44,46 @@ namespace meow::runtime {
             return value;
         }
 
+        size_t addConstant(const meow::common::Value& value) {
+            constantPool.push_back(value);
+            return constantPool.size() - 1;
+        }
+
         meow::common::Value readConstant(size_t index) const {
-            if (index < 0 || index >= constantPool.size()) {
+            if (index >= constantPool.size()) {
                 return meow::common::Value(meow::common::Null{});
             }
+            return constantPool[index];
+        }
+
+        // Instructions are rewritten in place by the interpreter (quickening), so the code stays mutable
+        inline uint8_t* data() noexcept {
+            return code.data();
+        }
+
+        inline const meow::common::Value* constants() const noexcept {
+            return constantPool.data();
+        }
+
+        inline size_t size() const noexcept {
+            return code.size();
+        }
+
+        inline size_t constantCount() const noexcept {
+            return constantPool.size();
+        }
+
+        inline uint16_t readShortAt(size_t offset) const {
+            return static_cast<uint16_t>(code[offset] | (code[offset + 1] << 8));
+        }
+
+        inline void patchShort(size_t offset, uint16_t value) {
+            code[offset] = static_cast<uint8_t>(value & 0xff);
+            code[offset + 1] = static_cast<uint8_t>((value >> 8) & 0xff);
+        }
+
+        inline void patchByte(size_t offset, uint8_t byte) {
+            code[offset] = byte;
         }
 
         inline void trace(meow::memory::GCVisitor& visitor) {
@@ -45,4 +92,4 @@ namespace meow::runtime {
             }
         }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file feedback.h
+ * @author lazypaws
+ * @brief Defines the type feedback the interpreter collects for adaptive optimizations
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/definitions.h"
+#include "common/pch.h"
+
+namespace meow::runtime {
+    // A proto starts quickening its instructions once it has been called, or has jumped backwards, this many times
+    constexpr uint32_t QUICKEN_INVOCATIONS = 2;
+    constexpr uint32_t QUICKEN_BACK_EDGES = 64;
+    // Call sites remember this many distinct targets, calls to any other target are only counted
+    constexpr size_t MAX_CALL_TARGETS = 4;
+    // Property sites remember this many distinct receiver classes, the same way
+    constexpr size_t MAX_PROPERTY_CLASSES = 4;
+
+    /**
+     * @brief A set of value types, one bit per alternative of Value
+     */
+    using TypeSet = uint32_t;
+
+    /**
+     * @brief Gets the type set holding only the type of a value
+     * @param[in] value The value
+     * @return The bit of the value's type
+     */
+    inline TypeSet typeOf(const meow::common::Value& value) noexcept {
+        return static_cast<TypeSet>(1u << value.index());
+    }
+
+    /**
+     * @struct TypeSite
+     * @brief The operand types seen by an arithmetic, comparison or indexing instruction
+     * @details Indexing instructions record the container as the first operand and the key as the second
+     */
+    struct TypeSite {
+        uint32_t pc;
+        TypeSet operands[2] = {};
+        uint32_t count = 0;
+    };
+
+    /**
+     * @struct CallSite
+     * @brief The targets seen by a call instruction, with how often each was called
+     */
+    struct CallSite {
+        uint32_t pc;
+        std::pair<meow::common::Proto, uint32_t> targets[MAX_CALL_TARGETS] = {};
+        uint32_t others = 0;    // Calls to targets that didn't fit
+    };
+
+    /**
+     * @struct PropertySite
+     * @brief The receivers seen by a GET_PROP or SET_PROP instruction
+     * @details Instances have no shapes, their class is what tells the property layouts apart
+     */
+    struct PropertySite {
+        uint32_t pc;
+        TypeSet receivers = 0;
+        std::pair<meow::common::Class, uint32_t> classes[MAX_PROPERTY_CLASSES] = {};
+        uint32_t others = 0;    // Accesses on instances of classes that didn't fit
+    };
+
+    /**
+     * @struct MethodSite
+     * @brief The inline cache of a method lookup by INVOKE, SUPER_INVOKE or GET_SUPER: the method its name resolved to in the last class
+     * @details An entry only holds while the class is the same and its method table didn't change since, which 'version' tells,
+     * and no superclass anywhere changed after being inherited from, which 'epoch' tells
+     */
+    struct MethodSite {
+        uint32_t pc;
+        meow::common::Class klass = nullptr;
+        uint32_t version = 0;
+        uint32_t epoch = 0;
+        meow::common::Value method = {};
+        uint32_t misses = 0;
+    };
+
+    /**
+     * @class FeedbackVector
+     * @brief The profile of one proto, allocated the first time one of its sites records something
+     * @details Sites are found once by scanning the chunk, and looked up through a table indexed by bytecode offset,
+     * which jump operands keep below 64K. Quickening rewrites opcodes but not instruction sizes, so the sites stay valid
+     */
+    class FeedbackVector {
+    public:
+        /**
+         * @brief Creates empty sites for every profiled instruction of a proto
+         * @param[in] proto The proto
+         */
+        explicit FeedbackVector(const meow::common::ObjProto& proto);
+
+        /**
+         * @brief Records the operand types of a type site
+         * @param[in] pc The bytecode offset of the instruction
+         * @param[in] lhs The first operand
+         * @param[in] rhs The second operand, null for unary instructions
+         * @return 'true' if the site only ever saw these types, so specializing it is worthwhile
+         */
+        bool observe(uint32_t pc, const meow::common::Value& lhs, const meow::common::Value& rhs = {}) noexcept;
+
+        /**
+         * @brief Records the target of a call site
+         * @param[in] pc The bytecode offset of the call
+         * @param[in] target The proto being called
+         */
+        void observeCall(uint32_t pc, meow::common::Proto target) noexcept;
+
+        /**
+         * @brief Records the receiver of a property site
+         * @param[in] pc The bytecode offset of the GET_PROP or SET_PROP instruction
+         * @param[in] receiver The value whose property is accessed
+         */
+        void observeProperty(uint32_t pc, const meow::common::Value& receiver) noexcept;
+
+        /**
+         * @brief Gets the type site of an instruction
+         * @param[in] pc The bytecode offset of the instruction
+         * @return The site, or nullptr if the instruction isn't profiled
+         */
+        const TypeSite* typeSite(uint32_t pc) const noexcept;
+
+        /**
+         * @brief Gets the call site of an instruction
+         * @param[in] pc The bytecode offset of the call
+         * @return The site, or nullptr if the instruction isn't a call
+         */
+        const CallSite* callSite(uint32_t pc) const noexcept;
+
+        /**
+         * @brief Gets the property site of an instruction
+         * @param[in] pc The bytecode offset of the GET_PROP or SET_PROP instruction
+         * @return The site, or nullptr if the instruction doesn't access properties
+         */
+        const PropertySite* propertySite(uint32_t pc) const noexcept;
+
+        /**
+         * @brief Gets the inline cache of a method lookup
+         * @param[in] pc The bytecode offset of the INVOKE or GET_SUPER instruction
+         * @return The mutable site, or nullptr if the instruction doesn't look methods up
+         */
+        MethodSite* methodSite(uint32_t pc) noexcept;
+
+        /**
+         * @brief Counts a failed speculation at an instruction
+         * @param[in] pc The bytecode offset of the instruction
+         */
+        void recordDeopt(uint32_t pc);
+
+        /**
+         * @brief Gets how often speculation failed at an instruction
+         * @param[in] pc The bytecode offset of the instruction
+         * @return The number of deoptimizations recorded for it
+         */
+        uint32_t deopts(uint32_t pc) const noexcept;
+
+        /**
+         * @brief Visits the call targets, receiver classes and cached methods, so they stay alive as long as the profile refers to them
+         * @param[in] visitor The visitor of the collector
+         */
+        void trace(meow::memory::GCVisitor& visitor);
+
+        /**
+         * @brief Writes the sites in a line-oriented text form
+         * @param[out] out The stream to write to
+         */
+        void dump(std::ostream& out) const;
+    private:
+        static constexpr uint16_t NO_SITE = std::numeric_limits<uint16_t>::max();
+
+        std::vector<uint16_t> siteAt;       // Index of the site of each offset in the vector of its kind
+        std::vector<TypeSite> typeSites;
+        std::vector<CallSite> callSites;
+        std::vector<MethodSite> methodSites;
+        std::vector<PropertySite> propertySites;
+        std::vector<std::pair<uint32_t, uint32_t>> deoptSites;  // Offset and count, deoptimizations are rare
+    };
+
+    /**
+     * @brief Writes the counters, tier and feedback of a proto and of the protos in its constants
+     * @param[in] proto The outermost proto
+     * @param[out] out The stream to write to
+     */
+    void dumpProfile(const meow::common::ObjProto& proto, std::ostream& out);
+}
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file linker.h
+ * @author lazypaws
+ * @brief Defines the bytecode linker of MeowScript
+ * @details Linking runs once per proto, after compilation and before the first execution.
+ * It resolves everything that can be resolved by name ahead of time, so the interpreter only does indexed loads
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/definitions.h"
+
+namespace meow::runtime {
+    /**
+     * @brief Links a proto and all protos nested in its constants against a module
+     * @details Rewrites the name operand of every \c GET_GLOBAL and \c SET_GLOBAL from a string constant index
+     * into a global slot index of the module, those of \c EXPORT into export slots, and those of \c GET_EXPORT and
+     * \c IMPORT_MODULE into indices of sites of the proto. It also builds the exception table of the proto from its
+     * \c SETUP_TRY / \c POP_TRY markers. Linking an already linked proto does nothing, and a proto that fails
+     * to link is left untouched, nested protos that did link stay linked
+     * @param[in,out] proto The proto to link
+     * @param[in,out] module The module owning the globals
+     * @warning Raises RuntimeError if a name operand isn't a string constant or try markers are unbalanced
+     */
+    void link(meow::common::Proto proto, meow::common::Module module);
+}
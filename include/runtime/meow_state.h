@@ -3,6 +3,7 @@
 #include "common/value.h"
 #include "common/definitions.h"
 #include "common/pch.h"
+#include "runtime/value_stack.h"
 
 namespace meow::memory {
     struct MeowObject;
@@ -11,21 +12,67 @@ namespace meow::memory {
 namespace meow::runtime {
     struct MeowState {
         std::vector<meow::common::CallFrame> callStack;
-        std::vector<meow::common::Value> stackSlots;
-        // std::vector<meow::common::Upvalue> openUpvalues;
-        // std::unordered_map<std::string, meow::common::Module> moduleCache;
-        // std::vector<meow::common::ExceptionHandler> exceptionHandlers;
-        
+        ValueStack stackSlots;
+        std::vector<meow::memory::MeowObject*> tempRoots;
+        meow::common::Upvalue openUpvalues = nullptr;  // Sorted by stack address, topmost first
+        std::vector<meow::memory::MeowObject*> moduleRoots;    // Modules loaded from files and their bodies
+
         void reset() {
             callStack.clear();
             stackSlots.clear();
-            // openUpvalues.clear();
-            // moduleCache.clear();
-            // exceptionHandlers.clear();
+            tempRoots.clear();
+            openUpvalues = nullptr;
         }
 
-        inline std::vector<meow::memory::MeowObject*> getRoots() const {
+        /**
+         * @brief Makes sure the stack holds at least a number of slots
+         * @param[in] slots The number of slots needed
+         * @note Slots never move, pointers into the stack stay valid
+         */
+        inline void ensureStack(size_t slots) {
+            stackSlots.ensure(slots);
+        }
+
+        /**
+         * @brief Gets the number of stack slots below the top of the highest frame
+         * @return The end of the live slots, the slot below each window holding its callee included
+         */
+        inline size_t liveSlots() const noexcept {
+            size_t top = 0;
+            for (const auto& frame : callStack) {
+                top = std::max(top, frame.base + frame.proto->registers);
+            }
+            return std::min(top, stackSlots.size());
+        }
+
+        /**
+         * @brief Resets the slots above the live frames to null
+         * @details Called by the collector, so a frame pushed later never sees an object freed while its slot was dead
+         */
+        inline void clearDeadSlots() noexcept {
+            for (size_t slot = liveSlots(); slot < stackSlots.size(); ++slot) {
+                stackSlots[slot] = meow::common::Null{};
+            }
+        }
 
+        inline std::vector<meow::memory::MeowObject*> getRoots() const {
+            std::vector<meow::memory::MeowObject*> roots(tempRoots);
+            roots.insert(roots.end(), moduleRoots.begin(), moduleRoots.end());
+            for (auto upvalue = openUpvalues; upvalue; upvalue = upvalue->next) {
+                roots.push_back(upvalue);
+            }
+            // A tail call leaves no register holding the running function
+            for (const auto& frame : callStack) {
+                roots.push_back(frame.proto);
+                if (frame.closure) roots.push_back(frame.closure);
+            }
+            // Slots above the live frames are garbage left by returned calls
+            for (size_t slot = 0, live = liveSlots(); slot < live; ++slot) {
+                if (auto object = meow::common::heapObject(stackSlots[slot])) {
+                    roots.push_back(object);
+                }
+            }
+            return roots;
         }
     };
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file compile_cache.h
+ * @author lazypaws
+ * @brief Defines the on-disk cache of compiled module bodies
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/definitions.h"
+#include "memory/memory_manager.h"
+#include "runtime/meow_state.h"
+#include "runtime/module/load_module.h"
+
+namespace meow::runtime::module {
+    // Bump when the cache entry layout, or the meaning of an existing opcode or its operands, changes
+    constexpr uint32_t CACHE_FORMAT_VERSION = 2;
+
+    /**
+     * @struct CachedModule
+     * @brief A cache entry read from disk, before anything is allocated on the heap
+     */
+    struct CachedModule {
+        std::vector<std::string> imports;   // Paths of the modules it imports, as written
+        std::string body;                   // The encoded protos
+    };
+
+    /**
+     * @class CompileCache
+     * @brief Keeps the bodies of compiled modules on disk, keyed by the hash of their source and the VM build
+     * @details Entries hold protos as the front end emitted them, before linking, along with the imports found in them.
+     * The header repeats the whole fingerprint of the source and the build, which MEOW_VM_BUILD names,
+     * and a checksum of the rest, so only an entry written by this VM for exactly this source is used.
+     * An entry is written to a temporary file and renamed into place, so concurrent processes never read a partial one
+     * and the last writer of identical content wins. A body with constants that can't be encoded is just not cached
+     */
+    class CompileCache {
+    public:
+        /**
+         * @param[in] directory Where entries are kept, created on the first store
+         */
+        explicit CompileCache(std::filesystem::path directory);
+
+        /**
+         * @brief Reads the entry of a source
+         * @details Touches no shared state, so it can run on any thread
+         * @param[in] source The source of the module
+         * @return The entry, or nothing if there is none or it doesn't match the source
+         */
+        std::optional<CachedModule> read(const SourceFile& source) const noexcept;
+
+        /**
+         * @brief Turns an entry back into the unlinked body of the module
+         * @param[in] heap The heap allocating the protos
+         * @param[in] state The state rooting them while they are built
+         * @param[in] cached The entry
+         * @return The body
+         * @warning Raises RuntimeError if the entry is corrupt, or any exception allocating it does
+         */
+        meow::common::Proto decode(meow::memory::MemoryManager& heap, MeowState& state, const CachedModule& cached) const;
+
+        /**
+         * @brief Writes the entry of a source, failures are ignored
+         * @param[in] source The source of the module
+         * @param[in] main The body the front end emitted for it, not linked yet
+         */
+        void store(const SourceFile& source, meow::common::Proto main) const noexcept;
+    private:
+        std::filesystem::path entryPath(const SourceFile& source) const;
+
+        std::filesystem::path directory;
+    };
+
+    /**
+     * @brief Checks if this build can keep a compile cache
+     * @return 'true' if the build names itself with MEOW_VM_BUILD, 'false' otherwise
+     */
+    bool isCacheSupported() noexcept;
+}
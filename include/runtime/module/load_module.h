@@ -1,13 +1,56 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file load_module.h
+ * @author lazypaws
+ * @brief Defines how module sources are read and recognized
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
 #pragma once
 
 #include "common/pch.h"
 
 namespace meow::runtime::module {
-    struct Module;
-    struct Diagnostic;
+    /**
+     * @struct Fingerprint
+     * @brief Identifies the content of a source file, the compile cache keys bodies by it
+     * @details Two unrelated hashes and the size, a file only matches if all three do
+     */
+    struct Fingerprint {
+        uintmax_t size = 0;
+        uint64_t hash = 0;
+        uint64_t check = 0;
+    };
 
-    struct ModuleManager {
-        
-        Module loadModule(const std::string& modulePath);
+    /**
+     * @struct SourceFile
+     * @brief The text of a module read from disk
+     */
+    struct SourceFile {
+        std::string path;   // Canonical
+        std::string text;
+        Fingerprint fingerprint;
     };
-}
\ No newline at end of file
+
+    /**
+     * @brief Hashes source text, 64-bit FNV-1a
+     * @param[in] text The text to hash
+     * @return The hash
+     */
+    uint64_t contentHash(std::string_view text) noexcept;
+
+    /**
+     * @brief Hashes data independently of contentHash, 64 bits at a time with a final avalanche
+     * @param[in] data The data to hash
+     * @return The hash
+     */
+    uint64_t contentCheck(std::string_view data) noexcept;
+
+    /**
+     * @brief Reads a module source file and fingerprints it
+     * @param[in] path The canonical path of the file
+     * @return The source
+     * @warning Raises RuntimeError if the file can't be read
+     */
+    SourceFile readSource(const std::filesystem::path& path);
+}
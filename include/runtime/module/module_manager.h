@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file module_manager.h
+ * @author lazypaws
+ * @brief Defines the module manager of MeowScript, which loads every module file once per VM
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/definitions.h"
+#include "memory/memory_manager.h"
+#include "runtime/meow_state.h"
+#include "runtime/module/compile_cache.h"
+#include "runtime/module/load_module.h"
+
+namespace meow::runtime::module {
+    /**
+     * @enum ModuleState
+     * @brief How far a loaded module got
+     */
+    enum class ModuleState : uint8_t {
+        DECLARED,   // Found on disk, not compiled yet
+        LOADED,     // Compiled and linked, its body hasn't run
+        EXECUTING,  // Its body is running, an import cycle sees the exports defined so far
+        EXECUTED,
+        FAILED      // Its body threw, importing it again rethrows
+    };
+
+    /**
+     * @struct ModuleRecord
+     * @brief A module file loaded by the manager
+     */
+    struct ModuleRecord {
+        meow::common::Module module;
+        meow::common::Proto main;       // The module body
+        ModuleState state = ModuleState::DECLARED;
+        // What the body threw, when FAILED. A script value is kept in 'thrown', rooted in MeowState::moduleRoots,
+        // and the error is made again from it, other errors hold no values and are kept as they are
+        std::exception_ptr error;
+        meow::common::Value thrown;
+        std::string message;
+    };
+
+    /**
+     * @struct ParsedModule
+     * @brief A module lexed and parsed by a Frontend, before anything is allocated on the heap
+     * @details Front ends derive from it to carry their syntax tree to Frontend::emit
+     */
+    struct ParsedModule {
+        std::vector<std::string> imports;   // Paths of the modules it imports, as written
+        virtual ~ParsedModule() = default;
+    };
+
+    /**
+     * @class Frontend
+     * @brief A front end split so that modules can be parsed concurrently
+     * @details The heap isn't thread safe, so only parsing runs on worker threads, emitting the body runs on the VM thread
+     */
+    class Frontend {
+    public:
+        virtual ~Frontend() = default;
+
+        /**
+         * @brief Lexes and parses the source of a module
+         * @details Called concurrently for different modules, it must not touch the heap or other shared state
+         * @param[in] source The source text
+         * @param[in] path The canonical path of the file, for diagnostics
+         * @return The parsed module
+         */
+        virtual std::unique_ptr<ParsedModule> parse(const std::string& source, const std::string& path) = 0;
+
+        /**
+         * @brief Turns a parsed module into its body, on the VM thread
+         * @param[in,out] parsed The module returned by parse
+         * @return The body
+         */
+        virtual meow::common::Proto emit(ParsedModule& parsed) = 0;
+    };
+
+    /**
+     * @class ModuleManager
+     * @brief Loads module files, caching them by canonical path
+     * @details Two imports naming the same file through different relative paths or links share one record,
+     * so a module imported from many places, diamonds included, is compiled and run once.
+     * Imports are also remembered by the path they were written with, joined to the importer's directory,
+     * so a path seen before takes no file system access. Each \c IMPORT_MODULE is resolved once, when its module
+     * is linked, and keeps the record in its ImportSite, so running it again does no path work at all.
+     * Modules and their bodies stay alive as long as the VM
+     */
+    class ModuleManager {
+    public:
+        /**
+         * @brief Turns the source of a module into its body, the front end is provided by the host
+         * @details Receives the source text and the canonical path of the file, for diagnostics
+         */
+        using Compiler = std::function<meow::common::Proto(const std::string& source, const std::string& path)>;
+
+        /**
+         * @param[in] heap The heap allocating modules
+         * @param[in] state The state rooting them
+         * @param[in] baseDirectory The directory paths are relative to when the importer isn't a file
+         */
+        ModuleManager(meow::memory::MemoryManager& heap, MeowState& state, std::filesystem::path baseDirectory);
+
+        void setCompiler(Compiler compiler);
+
+        // Takes precedence over the compiler, and lets preload parse in parallel
+        void setFrontend(std::unique_ptr<Frontend> frontend);
+
+        // Bodies are looked up there before compiling, and stored after, nullptr turns caching off
+        void setCache(std::unique_ptr<CompileCache> compileCache);
+
+        /**
+         * @brief Compiles the import graph of a module ahead of running it
+         * @details Follows imports from the entry module, reading and parsing the files found on a pool of threads.
+         * Each is emitted and linked on the calling thread afterwards, and left LOADED for loadModule to find,
+         * so the order bodies run in is still decided by the imports as they execute.
+         * Modules found in the compile cache aren't parsed, their imports are kept in the entry.
+         * Files that fail to load are skipped, importing them reports the error. Does nothing without a Frontend
+         * @param[in] entryPath The path of the entry module, relative to the base directory
+         * @param[in] threads How many threads to parse on
+         */
+        void preload(const std::string& entryPath, unsigned threads);
+
+        /**
+         * @brief Gets the module a path names, loading it the first time
+         * @details The path is relative to the directory of the importer, ".meow" is added if it has no extension.
+         * The body of the returned module may not have run yet, the caller runs it
+         * @param[in] modulePath The path as written in the import
+         * @param[in] importer The importing module, or nullptr
+         * @return The record of the module
+         * @warning Raises RuntimeError if the file can't be read, or no compiler is set
+         */
+        ModuleRecord& loadModule(const std::string& modulePath, meow::common::Module importer = nullptr);
+
+        /**
+         * @brief Gets the module a path names without compiling it, for lazy imports
+         * @details Paths are resolved like loadModule does. A module seen for the first time is left DECLARED,
+         * an empty pending module that materialize compiles once it's needed
+         * @param[in] modulePath The path as written in the import
+         * @param[in] importer The importing module, or nullptr
+         * @return The record of the module
+         * @warning Raises RuntimeError if the file doesn't exist
+         */
+        ModuleRecord& declareModule(const std::string& modulePath, meow::common::Module importer = nullptr);
+
+        /**
+         * @brief Compiles and links a DECLARED module, leaving it LOADED
+         * @param[in,out] record The module
+         * @warning Raises RuntimeError if the file can't be read, or no compiler is set. The module stays DECLARED
+         */
+        void materialize(ModuleRecord& record);
+
+        /**
+         * @brief Finds the record of a module loaded from a file
+         * @param[in] module The module
+         * @return The record, or nullptr if the module wasn't loaded by this manager
+         */
+        ModuleRecord* findRecord(meow::common::Module module) noexcept;
+    private:
+        meow::common::Proto compile(const SourceFile& source);
+        meow::common::Proto decodeOrCompile(const SourceFile& source, const std::optional<CachedModule>& cached, const std::function<meow::common::Proto()>& emit);
+        ModuleRecord& declare(const std::string& canonicalPath);
+        void build(ModuleRecord& record, const SourceFile& source, const std::function<meow::common::Proto()>& emit);
+        void resolveImports(meow::common::Proto main, meow::common::Module importer) noexcept;
+
+        meow::memory::MemoryManager& heap;
+        MeowState& state;
+        std::filesystem::path baseDirectory;
+        Compiler compiler;
+        std::unique_ptr<Frontend> frontend;
+        std::unique_ptr<CompileCache> cache;
+        std::unordered_map<std::string, std::unique_ptr<ModuleRecord>> modules;    // By canonical path
+        std::unordered_map<std::string, ModuleRecord*> imports;     // By import path joined to the importer's directory
+    };
+}
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file native.h
+ * @author lazypaws
+ * @brief Defines the bindings exposing host functions to MeowScript
+ * @details A plain C++ function becomes a native with makeNative<function>(heap, name). Its signature is read at
+ * compile time: the adapter unboxes each argument to the declared parameter type and boxes the result, so a call
+ * costs one indirect call and no argument copies
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/definitions.h"
+#include "memory/memory_manager.h"
+#include "common/pch.h"
+
+namespace meow::runtime {
+    namespace detail {
+        template <typename T, size_t I = 0>
+        constexpr uint32_t typeBit() noexcept {
+            if constexpr (std::is_same_v<std::variant_alternative_t<I, meow::common::BaseValue>, T>) {
+                return static_cast<uint32_t>(1u << I);
+            } else {
+                return typeBit<T, I + 1>();
+            }
+        }
+    }
+
+    /**
+     * @struct NativeParam
+     * @brief How a parameter type is read from an argument register
+     * @details 'accepts' is the set of value types the VM lets through, 'get' unboxes one of them
+     * @tparam T The C++ parameter type, without reference or const
+     */
+    template <typename T>
+    struct NativeParam {
+        static constexpr uint32_t accepts = detail::typeBit<T>();
+        static T get(const meow::common::Value& value) noexcept { return value.get<T>(); }
+    };
+
+    // Floats take integers as well, math functions shouldn't care how a number was written
+    template <>
+    struct NativeParam<meow::common::Float> {
+        static constexpr uint32_t accepts = detail::typeBit<meow::common::Float>() | detail::typeBit<meow::common::Int>();
+        static meow::common::Float get(const meow::common::Value& value) noexcept {
+            if (const meow::common::Float* f = value.get_if<meow::common::Float>()) return *f;
+            return static_cast<meow::common::Float>(value.get<meow::common::Int>());
+        }
+    };
+
+    template <>
+    struct NativeParam<meow::common::Value> {
+        static constexpr uint32_t accepts = std::numeric_limits<uint32_t>::max();
+        static const meow::common::Value& get(const meow::common::Value& value) noexcept { return value; }
+    };
+
+    /**
+     * @struct NativeResult
+     * @brief How a return type is boxed into a value
+     * @tparam T The C++ return type
+     */
+    template <typename T>
+    struct NativeResult {
+        static meow::common::Value box(meow::memory::MemoryManager&, T result) { return meow::common::Value(result); }
+    };
+
+    template <>
+    struct NativeResult<std::string> {
+        static meow::common::Value box(meow::memory::MemoryManager& heap, std::string result) {
+            return heap.newObject<meow::common::ObjString>(result);
+        }
+    };
+
+    namespace detail {
+        template <auto F, typename R, typename... Params, size_t... I>
+        meow::common::Value invoke(meow::memory::MemoryManager& heap, const meow::common::Value* args, std::index_sequence<I...>) {
+            if constexpr (std::is_void_v<R>) {
+                F(NativeParam<std::remove_cvref_t<Params>>::get(args[I])...);
+                return meow::common::Null{};
+            } else {
+                return NativeResult<std::remove_cvref_t<R>>::box(heap, F(NativeParam<std::remove_cvref_t<Params>>::get(args[I])...));
+            }
+        }
+
+        template <auto F, typename R, typename... Params>
+        struct Adapter {
+            static_assert(sizeof...(Params) <= meow::common::ObjNative::MAX_PARAMS, "too many parameters for a native");
+            static constexpr size_t arity = sizeof...(Params);
+            static constexpr uint32_t kinds[arity + 1] = {NativeParam<std::remove_cvref_t<Params>>::accepts..., 0};
+
+            static meow::common::Value call(meow::memory::MemoryManager& heap, const meow::common::Value* args) {
+                return invoke<F, R, Params...>(heap, args, std::index_sequence_for<Params...>{});
+            }
+        };
+
+        // Functions are bound through their pointer, captureless lambdas through their call operator
+        template <auto F, typename Signature>
+        struct Binding;
+        template <auto F, typename R, typename... Params>
+        struct Binding<F, R (*)(Params...)> : Adapter<F, R, Params...> {};
+        template <auto F, typename R, typename... Params>
+        struct Binding<F, R (*)(Params...) noexcept> : Adapter<F, R, Params...> {};
+        template <auto F, typename C, typename R, typename... Params>
+        struct Binding<F, R (C::*)(Params...) const> : Adapter<F, R, Params...> {};
+        template <auto F, typename C, typename R, typename... Params>
+        struct Binding<F, R (C::*)(Params...) const noexcept> : Adapter<F, R, Params...> {};
+
+        template <typename T>
+        struct SignatureOf { using type = T; };
+        template <typename T> requires std::is_class_v<T>
+        struct SignatureOf<T> { using type = decltype(&T::operator()); };
+
+        template <auto F>
+        using BindingOf = Binding<F, typename SignatureOf<decltype(F)>::type>;
+    }
+
+    /**
+     * @brief Wraps a host function into a native
+     * @tparam F The function, or a captureless lambda
+     * @param[in] heap The heap allocating the native
+     * @param[in] name The name used in error messages
+     * @return The native, managed by the collector
+     */
+    template <auto F>
+    meow::common::Native makeNative(meow::memory::MemoryManager& heap, std::string name) {
+        using Binding = detail::BindingOf<F>;
+        return heap.newObject<meow::common::ObjNative>(std::move(name), &Binding::call, Binding::arity, Binding::kinds);
+    }
+
+    /**
+     * @brief Checks arguments against the signature of a native
+     * @param[in] native The native being called
+     * @param[in] args The first argument register
+     * @param[in] argc The number of arguments
+     * @throw RuntimeError if the count or a type doesn't match
+     */
+    void checkArguments(const meow::common::ObjNative& native, const meow::common::Value* args, size_t argc);
+
+    /**
+     * @brief Makes the native constructing StringBuilder objects
+     * @param[in] heap The heap allocating the native
+     * @return The native, taking no arguments
+     */
+    meow::common::Native makeStringBuilder(meow::memory::MemoryManager& heap);
+
+    /**
+     * @brief Calls a method of a StringBuilder
+     * @details append(values...) and clear() return the builder so calls chain, toString() copies the buffer
+     * into a string and size() counts its characters
+     * @param[in] heap The heap allocating the result
+     * @param[in] builder The receiver
+     * @param[in] name The method name
+     * @param[in] args The first argument register
+     * @param[in] argc The number of arguments
+     * @return The result of the method
+     * @throw RuntimeError if there's no such method or the argument count doesn't match
+     */
+    meow::common::Value invokeStringBuilder(meow::memory::MemoryManager& heap, meow::common::StringBuilder builder,
+                                            const std::string& name, const meow::common::Value* args, size_t argc);
+}
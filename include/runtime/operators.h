@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file operators.h
+ * @author lazypaws
+ * @brief Defines the generic (type-dispatching) operators of MeowScript
+ * @details Generic instructions, which is all code before its proto is warm, call these directly.
+ * Quickened instructions fall back to them when their type guard misses
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/value.h"
+#include "memory/memory_manager.h"
+
+namespace meow::runtime::operators {
+    // Left shifts of more bits than this, and powers whose result may take more bits, raise an error
+    // instead of trying to allocate the result
+    constexpr meow::common::Int MAX_BIG_SHIFT = 1 << 24;
+
+    /**
+     * @brief Gets the MeowScript name of the type held by a value
+     * @param[in] value The value to inspect
+     * @return The type name, used in error messages
+     */
+    std::string typeName(const meow::common::Value& value);
+
+    /**
+     * @name Arithmetic
+     * @details Int results that overflow are promoted to BigInt instead of wrapping around,
+     * and BigInt results that fit in Int are demoted back
+     */
+    meow::common::Value add(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value subtract(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+
+    /**
+     * @brief Adds to a string that the result replaces, as in \c s = s + x
+     * @details Same result as add, but the result may take the buffer of 'lhs' over and append in place
+     */
+    meow::common::Value append(meow::memory::MemoryManager& heap, meow::common::String lhs, const meow::common::Value& rhs);
+    meow::common::Value multiply(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value divide(const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value modulo(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value power(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value negate(meow::memory::MemoryManager& heap, const meow::common::Value& value);
+
+    /**
+     * @name Bitwise
+     * @details BigInt operands behave as two's complement integers of unbounded width, like Int does within 64 bits
+     */
+    meow::common::Value bitAnd(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value bitOr(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value bitXor(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value bitNot(meow::memory::MemoryManager& heap, const meow::common::Value& value);
+    meow::common::Value shiftLeft(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+    meow::common::Value shiftRight(meow::memory::MemoryManager& heap, const meow::common::Value& lhs, const meow::common::Value& rhs);
+
+    /**
+     * @brief Checks if two values are equal
+     * @details Numbers compare by value, strings by content and other objects by identity
+     */
+    bool equals(const meow::common::Value& lhs, const meow::common::Value& rhs);
+
+    /**
+     * @brief Checks if a value is less than another
+     * @warning Raises RuntimeError if the values aren't both numbers or both strings
+     */
+    bool lessThan(const meow::common::Value& lhs, const meow::common::Value& rhs);
+
+    /**
+     * @brief Checks if a value is less than or equal to another
+     * @warning Raises RuntimeError if the values aren't both numbers or both strings
+     */
+    bool lessEqual(const meow::common::Value& lhs, const meow::common::Value& rhs);
+
+    /**
+     * @brief Reads an element of an array, a byte array, a string or an object
+     * @return The element, or null if an object doesn't have the key
+     * @warning Raises RuntimeError when an index is out of bounds
+     */
+    meow::common::Value getIndex(meow::memory::MemoryManager& heap, const meow::common::Value& container, const meow::common::Value& key);
+
+    /**
+     * @brief Writes an element of an array, a byte array or an object
+     * @warning Raises RuntimeError when an index is out of bounds
+     */
+    void setIndex(const meow::common::Value& container, const meow::common::Value& key, const meow::common::Value& value);
+}
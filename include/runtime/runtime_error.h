@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file runtime_error.h
+ * @author lazypaws
+ * @brief Defines errors raised while executing MeowScript bytecode
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/pch.h"
+#include "common/value.h"
+
+namespace meow::runtime {
+    /**
+     * @struct RuntimeError
+     * @brief Raised by the interpreter when an instruction can't be executed
+     */
+    struct RuntimeError : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * @struct ScriptError
+     * @brief Carries a value thrown by a script out of the interpreter when no handler catches it
+     */
+    struct ScriptError : RuntimeError {
+        meow::common::Value value;
+
+        /**
+         * @brief Constructs an error from a thrown value
+         * @param[in] thrown The value thrown by the script
+         * @param[in] message The description of the thrown value
+         */
+        ScriptError(const meow::common::Value& thrown, const std::string& message) : RuntimeError(message), value(thrown) {}
+    };
+}
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file value_stack.h
+ * @author lazypaws
+ * @brief Defines the value stack backing all register windows of MeowScript
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#pragma once
+
+#include "common/value.h"
+#include "common/pch.h"
+
+namespace meow::runtime {
+    /**
+     * @class ValueStack
+     * @brief A contiguous stack of values whose addresses never move
+     * @details The whole capacity is reserved as inaccessible virtual memory up front, and pages are committed
+     * on demand as the stack grows. Growing never reallocates, so raw pointers into frames and open upvalues
+     * stay valid for the lifetime of the stack. An inaccessible guard page follows the reservation,
+     * so a write past the hard limit faults instead of corrupting memory
+     */
+    class ValueStack {
+    public:
+        static constexpr size_t DEFAULT_MAX_SLOTS = 1 << 22;
+
+        /**
+         * @brief Reserves the address range of the stack
+         * @param[in] maxSlots The hard limit of slots the stack can ever hold
+         */
+        explicit ValueStack(size_t maxSlots = DEFAULT_MAX_SLOTS);
+        ~ValueStack();
+
+        ValueStack(const ValueStack&) = delete;
+        ValueStack& operator=(const ValueStack&) = delete;
+
+        /**
+         * @brief Makes sure at least a number of slots are committed
+         * @details Commits geometrically so a deep recursion costs amortized O(1) per call
+         * @param[in] slots The number of slots needed
+         * @warning Raises RuntimeError when the hard limit is exceeded
+         */
+        inline void ensure(size_t slots) {
+            if (slots <= committed) [[likely]] return;
+            grow(slots);
+        }
+
+        /** @brief Resets every committed slot to null, keeping the pages committed */
+        void clear() noexcept;
+
+        inline meow::common::Value* data() noexcept {
+            return slots;
+        }
+
+        inline const meow::common::Value* data() const noexcept {
+            return slots;
+        }
+
+        inline meow::common::Value& operator[](size_t index) noexcept {
+            return slots[index];
+        }
+
+        inline const meow::common::Value& operator[](size_t index) const noexcept {
+            return slots[index];
+        }
+
+        /**
+         * @brief Gets the number of committed slots
+         * @return Number of slots that can be accessed
+         */
+        inline size_t size() const noexcept {
+            return committed;
+        }
+
+        inline const meow::common::Value* begin() const noexcept {
+            return slots;
+        }
+
+        inline const meow::common::Value* end() const noexcept {
+            return slots + committed;
+        }
+    private:
+        void grow(size_t slots);
+
+        meow::common::Value* slots;
+        size_t committed;
+        size_t maxSlots;
+        size_t reservedBytes;
+    };
+}
@@ -0,0 +1,447 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file big_integer.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript arbitrary-precision integers
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "common/big_integer.h"
+
+using namespace meow::common;
+
+namespace {
+    using Magnitude = std::vector<uint32_t>;
+
+    void trim(Magnitude& magnitude) noexcept {
+        while (!magnitude.empty() && magnitude.back() == 0) {
+            magnitude.pop_back();
+        }
+    }
+
+    int compareMagnitude(const Magnitude& lhs, const Magnitude& rhs) noexcept {
+        if (lhs.size() != rhs.size()) return lhs.size() < rhs.size() ? -1 : 1;
+        for (size_t i = lhs.size(); i-- > 0;) {
+            if (lhs[i] != rhs[i]) return lhs[i] < rhs[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    Magnitude addMagnitude(const Magnitude& lhs, const Magnitude& rhs) {
+        const Magnitude& longer = lhs.size() >= rhs.size() ? lhs : rhs;
+        const Magnitude& shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+        Magnitude result(longer.size() + 1);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < longer.size(); ++i) {
+            uint64_t sum = static_cast<uint64_t>(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+            result[i] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+        result[longer.size()] = static_cast<uint32_t>(carry);
+        trim(result);
+        return result;
+    }
+
+    // Requires lhs >= rhs
+    Magnitude subtractMagnitude(const Magnitude& lhs, const Magnitude& rhs) {
+        Magnitude result(lhs.size());
+        int64_t borrow = 0;
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            int64_t difference = static_cast<int64_t>(lhs[i]) - (i < rhs.size() ? rhs[i] : 0) - borrow;
+            borrow = difference < 0;
+            result[i] = static_cast<uint32_t>(difference + (borrow << 32));
+        }
+        trim(result);
+        return result;
+    }
+
+    Magnitude schoolbookMultiply(const Magnitude& lhs, const Magnitude& rhs) {
+        if (lhs.empty() || rhs.empty()) return {};
+        Magnitude result(lhs.size() + rhs.size());
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < rhs.size(); ++j) {
+                uint64_t product = static_cast<uint64_t>(lhs[i]) * rhs[j] + result[i + j] + carry;
+                result[i + j] = static_cast<uint32_t>(product);
+                carry = product >> 32;
+            }
+            result[i + rhs.size()] = static_cast<uint32_t>(carry);
+        }
+        trim(result);
+        return result;
+    }
+
+    Magnitude slice(const Magnitude& magnitude, size_t from, size_t to) {
+        from = std::min(from, magnitude.size());
+        to = std::min(to, magnitude.size());
+        Magnitude result(magnitude.begin() + from, magnitude.begin() + to);
+        trim(result);
+        return result;
+    }
+
+    // Adds addend * 2^(32 * offset) into target
+    void addShifted(Magnitude& target, const Magnitude& addend, size_t offset) {
+        if (target.size() < addend.size() + offset + 1) {
+            target.resize(addend.size() + offset + 1);
+        }
+        uint64_t carry = 0;
+        size_t i = 0;
+        for (; i < addend.size(); ++i) {
+            uint64_t sum = static_cast<uint64_t>(target[i + offset]) + addend[i] + carry;
+            target[i + offset] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+        for (; carry && i + offset < target.size(); ++i) {
+            uint64_t sum = static_cast<uint64_t>(target[i + offset]) + carry;
+            target[i + offset] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+        if (carry) target.push_back(static_cast<uint32_t>(carry));
+    }
+
+    /**
+     * @brief Multiplies magnitudes with Karatsuba's algorithm
+     * @details Splits both operands at half the longer size: x = x1 * B + x0, y = y1 * B + y0, then
+     * x * y = z2 * B^2 + ((x0 + x1)(y0 + y1) - z2 - z0) * B + z0 with z2 = x1 * y1 and z0 = x0 * y0,
+     * three half-size products instead of four
+     */
+    Magnitude multiplyMagnitude(const Magnitude& lhs, const Magnitude& rhs) {
+        if (std::min(lhs.size(), rhs.size()) < BigInteger::KARATSUBA_THRESHOLD) {
+            return schoolbookMultiply(lhs, rhs);
+        }
+
+        size_t half = std::max(lhs.size(), rhs.size()) / 2;
+        Magnitude x0 = slice(lhs, 0, half), x1 = slice(lhs, half, lhs.size());
+        Magnitude y0 = slice(rhs, 0, half), y1 = slice(rhs, half, rhs.size());
+
+        Magnitude z0 = multiplyMagnitude(x0, y0);
+        Magnitude z2 = multiplyMagnitude(x1, y1);
+        Magnitude z1 = multiplyMagnitude(addMagnitude(x0, x1), addMagnitude(y0, y1));
+        z1 = subtractMagnitude(subtractMagnitude(z1, z2), z0);
+
+        Magnitude result = z0;
+        addShifted(result, z1, half);
+        addShifted(result, z2, 2 * half);
+        trim(result);
+        return result;
+    }
+
+    // Divides in place by a single limb and returns the remainder
+    uint32_t divideBySmall(Magnitude& magnitude, uint32_t divisor) noexcept {
+        uint64_t remainder = 0;
+        for (size_t i = magnitude.size(); i-- > 0;) {
+            uint64_t current = (remainder << 32) | magnitude[i];
+            magnitude[i] = static_cast<uint32_t>(current / divisor);
+            remainder = current % divisor;
+        }
+        trim(magnitude);
+        return static_cast<uint32_t>(remainder);
+    }
+
+    Magnitude shiftLeftMagnitude(const Magnitude& magnitude, uint64_t bits) {
+        if (magnitude.empty()) return {};
+        size_t limbShift = static_cast<size_t>(bits / 32);
+        unsigned bitShift = static_cast<unsigned>(bits % 32);
+        Magnitude result(magnitude.size() + limbShift + 1);
+        for (size_t i = 0; i < magnitude.size(); ++i) {
+            uint64_t shifted = static_cast<uint64_t>(magnitude[i]) << bitShift;
+            result[i + limbShift] |= static_cast<uint32_t>(shifted);
+            result[i + limbShift + 1] |= static_cast<uint32_t>(shifted >> 32);
+        }
+        trim(result);
+        return result;
+    }
+
+    // The low limbs of the two's complement of a signed magnitude, sign-extended to 'size' limbs.
+    // Applied to a negative two's complement, gives its magnitude back
+    Magnitude twosComplement(bool negative, const Magnitude& magnitude, size_t size) {
+        Magnitude result(magnitude);
+        result.resize(size);
+        if (negative) {
+            uint64_t carry = 1;
+            for (uint32_t& limb : result) {
+                uint64_t sum = static_cast<uint64_t>(~limb) + carry;
+                limb = static_cast<uint32_t>(sum);
+                carry = sum >> 32;
+            }
+        }
+        return result;
+    }
+
+    // Drops the low bits, rounding the magnitude toward zero
+    Magnitude shiftRightMagnitude(const Magnitude& magnitude, uint64_t bits) {
+        if (bits / 32 >= magnitude.size()) return {};
+        size_t limbShift = static_cast<size_t>(bits / 32);
+        unsigned bitShift = static_cast<unsigned>(bits % 32);
+        Magnitude result(magnitude.size() - limbShift);
+        for (size_t i = 0; i < result.size(); ++i) {
+            uint64_t high = i + limbShift + 1 < magnitude.size() ? magnitude[i + limbShift + 1] : 0;
+            result[i] = static_cast<uint32_t>(((high << 32) | magnitude[i + limbShift]) >> bitShift);
+        }
+        trim(result);
+        return result;
+    }
+
+    // Checks if any of the low bits is set
+    bool anyLowBit(const Magnitude& magnitude, uint64_t bits) noexcept {
+        size_t limbShift = static_cast<size_t>(std::min<uint64_t>(bits / 32, magnitude.size()));
+        for (size_t i = 0; i < limbShift; ++i) {
+            if (magnitude[i]) return true;
+        }
+        unsigned bitShift = static_cast<unsigned>(bits % 32);
+        return limbShift < magnitude.size() && bitShift && (magnitude[limbShift] & ((1u << bitShift) - 1));
+    }
+
+    /**
+     * @brief Divides magnitudes of two limbs or more with Knuth's algorithm D (TAOCP vol. 2, 4.3.1)
+     * @details Both operands are first shifted so the top bit of the divisor is set, then each quotient limb is
+     * estimated from the top two limbs of the remainder and the top limb of the divisor. Normalized, the estimate
+     * is corrected down by the next divisor limb and is then at most one too large, which the add back fixes
+     * @warning Requires dividend >= divisor and divisor.size() >= 2
+     */
+    void divideMagnitude(const Magnitude& dividend, const Magnitude& divisor, Magnitude& quotient, Magnitude& remainder) {
+        constexpr uint64_t BASE = 1ULL << 32;
+        size_t n = divisor.size(), m = dividend.size() - n;
+        unsigned shift = static_cast<unsigned>(std::countl_zero(divisor.back()));
+        auto shifted = [shift](const Magnitude& magnitude, size_t i) -> uint32_t {
+            uint32_t low = i > 0 && shift ? magnitude[i - 1] >> (32 - shift) : 0;
+            return i < magnitude.size() ? (magnitude[i] << shift) | low : low;
+        };
+        Magnitude v(n), u(m + n + 1);
+        for (size_t i = 0; i < n; ++i) v[i] = shifted(divisor, i);
+        for (size_t i = 0; i <= m + n; ++i) u[i] = shifted(dividend, i);
+
+        quotient.assign(m + 1, 0);
+        for (size_t j = m + 1; j-- > 0;) {
+            uint64_t top = (static_cast<uint64_t>(u[j + n]) << 32) | u[j + n - 1];
+            uint64_t estimate = top / v[n - 1], rest = top % v[n - 1];
+            while (estimate >= BASE || estimate * v[n - 2] > ((rest << 32) | u[j + n - 2])) {
+                --estimate;
+                rest += v[n - 1];
+                if (rest >= BASE) break;
+            }
+
+            // u[j .. j + n] -= estimate * v
+            uint64_t carry = 0;
+            int64_t borrow = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t product = estimate * v[i] + carry;
+                carry = product >> 32;
+                int64_t difference = static_cast<int64_t>(u[i + j]) - static_cast<uint32_t>(product) - borrow;
+                u[i + j] = static_cast<uint32_t>(difference);
+                borrow = difference < 0;
+            }
+            int64_t difference = static_cast<int64_t>(u[j + n]) - static_cast<int64_t>(carry) - borrow;
+            u[j + n] = static_cast<uint32_t>(difference);
+
+            // The estimate was one too large: add the divisor back
+            if (difference < 0) {
+                --estimate;
+                carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t sum = static_cast<uint64_t>(u[i + j]) + v[i] + carry;
+                    u[i + j] = static_cast<uint32_t>(sum);
+                    carry = sum >> 32;
+                }
+                u[j + n] += static_cast<uint32_t>(carry);
+            }
+            quotient[j] = static_cast<uint32_t>(estimate);
+        }
+
+        remainder.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t pair = (static_cast<uint64_t>(u[i + 1]) << 32) | u[i];
+            remainder[i] = static_cast<uint32_t>(pair >> shift);
+        }
+        trim(quotient);
+        trim(remainder);
+    }
+}
+
+BigInteger::BigInteger(int64_t value) {
+    negative = value < 0;
+    uint64_t magnitude = negative ? 0ULL - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    while (magnitude) {
+        limbs.push_back(static_cast<uint32_t>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+void BigInteger::normalize() noexcept {
+    trim(limbs);
+    if (limbs.empty()) negative = false;
+}
+
+uint64_t BigInteger::bitLength() const noexcept {
+    if (limbs.empty()) return 0;
+    return (limbs.size() - 1) * 32 + (32 - static_cast<uint64_t>(std::countl_zero(limbs.back())));
+}
+
+bool BigInteger::fitsInt() const noexcept {
+    if (limbs.size() <= 1) return true;
+    if (limbs.size() > 2) return false;
+    uint64_t magnitude = (static_cast<uint64_t>(limbs[1]) << 32) | limbs[0];
+    return negative ? magnitude <= (1ULL << 63) : magnitude < (1ULL << 63);
+}
+
+int64_t BigInteger::toInt() const noexcept {
+    uint64_t magnitude = 0;
+    for (size_t i = std::min<size_t>(limbs.size(), 2); i-- > 0;) {
+        magnitude = (magnitude << 32) | limbs[i];
+    }
+    return static_cast<int64_t>(negative ? 0ULL - magnitude : magnitude);
+}
+
+double BigInteger::toDouble() const noexcept {
+    double result = 0.0;
+    for (size_t i = limbs.size(); i-- > 0;) {
+        result = result * 4294967296.0 + limbs[i];
+    }
+    return negative ? -result : result;
+}
+
+std::string BigInteger::toString() const {
+    if (limbs.empty()) return "0";
+
+    // Peels 9 decimal digits at a time
+    Magnitude magnitude = limbs;
+    std::vector<uint32_t> chunks;
+    while (!magnitude.empty()) {
+        chunks.push_back(divideBySmall(magnitude, 1000000000u));
+    }
+
+    std::string out = negative ? "-" : "";
+    out += std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+        std::string digits = std::to_string(chunks[i]);
+        out.append(9 - digits.size(), '0');
+        out += digits;
+    }
+    return out;
+}
+
+BigInteger BigInteger::operator-() const {
+    BigInteger result = *this;
+    if (!result.limbs.empty()) result.negative = !negative;
+    return result;
+}
+
+// ~x == -x - 1 in two's complement
+BigInteger BigInteger::operator~() const {
+    return -*this - BigInteger(1);
+}
+
+BigInteger BigInteger::bitwise(const BigInteger& lhs, const BigInteger& rhs, uint32_t (*op)(uint32_t, uint32_t)) {
+    // One limb more than the longer operand holds the sign of both, and of the result
+    size_t size = std::max(lhs.limbs.size(), rhs.limbs.size()) + 1;
+    Magnitude left = twosComplement(lhs.negative, lhs.limbs, size);
+    Magnitude right = twosComplement(rhs.negative, rhs.limbs, size);
+    for (size_t i = 0; i < size; ++i) {
+        left[i] = op(left[i], right[i]);
+    }
+
+    BigInteger result;
+    result.negative = left.back() >> 31;
+    result.limbs = result.negative ? twosComplement(true, left, size) : std::move(left);
+    result.normalize();
+    return result;
+}
+
+namespace meow::common {
+    BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs) {
+        BigInteger result;
+        if (lhs.negative == rhs.negative) {
+            result.limbs = addMagnitude(lhs.limbs, rhs.limbs);
+            result.negative = lhs.negative;
+        } else if (compareMagnitude(lhs.limbs, rhs.limbs) >= 0) {
+            result.limbs = subtractMagnitude(lhs.limbs, rhs.limbs);
+            result.negative = lhs.negative;
+        } else {
+            result.limbs = subtractMagnitude(rhs.limbs, lhs.limbs);
+            result.negative = rhs.negative;
+        }
+        result.normalize();
+        return result;
+    }
+
+    BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs) {
+        return lhs + (-rhs);
+    }
+
+    BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs) {
+        BigInteger result;
+        result.limbs = multiplyMagnitude(lhs.limbs, rhs.limbs);
+        result.negative = lhs.negative != rhs.negative;
+        result.normalize();
+        return result;
+    }
+
+    BigInteger operator&(const BigInteger& lhs, const BigInteger& rhs) {
+        return BigInteger::bitwise(lhs, rhs, [](uint32_t a, uint32_t b) { return a & b; });
+    }
+
+    BigInteger operator|(const BigInteger& lhs, const BigInteger& rhs) {
+        return BigInteger::bitwise(lhs, rhs, [](uint32_t a, uint32_t b) { return a | b; });
+    }
+
+    BigInteger operator^(const BigInteger& lhs, const BigInteger& rhs) {
+        return BigInteger::bitwise(lhs, rhs, [](uint32_t a, uint32_t b) { return a ^ b; });
+    }
+
+    int compare(const BigInteger& lhs, const BigInteger& rhs) noexcept {
+        if (lhs.negative != rhs.negative) return lhs.negative ? -1 : 1;
+        int magnitude = compareMagnitude(lhs.limbs, rhs.limbs);
+        return lhs.negative ? -magnitude : magnitude;
+    }
+}
+
+void BigInteger::divide(const BigInteger& dividend, const BigInteger& divisor, BigInteger& quotient, BigInteger& remainder) {
+    Magnitude q, r;
+    if (divisor.limbs.size() == 1) {
+        q = dividend.limbs;
+        uint32_t rest = divideBySmall(q, divisor.limbs[0]);
+        if (rest) r.push_back(rest);
+    } else if (compareMagnitude(dividend.limbs, divisor.limbs) >= 0) {
+        divideMagnitude(dividend.limbs, divisor.limbs, q, r);
+    } else {
+        r = dividend.limbs;
+    }
+
+    quotient.limbs = std::move(q);
+    quotient.negative = dividend.negative != divisor.negative;
+    quotient.normalize();
+    remainder.limbs = std::move(r);
+    remainder.negative = dividend.negative;
+    remainder.normalize();
+}
+
+BigInteger BigInteger::pow(uint64_t exponent) const {
+    BigInteger result(1), base = *this;
+    while (exponent) {
+        if (exponent & 1) result = result * base;
+        exponent >>= 1;
+        if (exponent) base = base * base;
+    }
+    return result;
+}
+
+BigInteger BigInteger::shiftLeft(uint64_t bits) const {
+    BigInteger result;
+    result.limbs = shiftLeftMagnitude(limbs, bits);
+    result.negative = negative;
+    result.normalize();
+    return result;
+}
+
+BigInteger BigInteger::shiftRight(uint64_t bits) const {
+    BigInteger result;
+    result.limbs = shiftRightMagnitude(limbs, bits);
+    result.negative = negative;
+
+    // Dropping bits rounds the magnitude toward zero, an arithmetic shift rounds negative values down
+    if (negative && anyLowBit(limbs, bits)) {
+        result.limbs = addMagnitude(result.limbs, Magnitude{1});
+    }
+    result.normalize();
+    return result;
+}
@@ -1,2 +1,25 @@
 #include "common/definitions.h"
+#include "runtime/chunk.h"
+#include "jit/compiled_code.h"
+#include "jit/trace.h"
+#include "runtime/feedback.h"
 
+using namespace meow::common;
+
+ObjProto::~ObjProto() {
+    delete chunk;
+    delete compiled;
+    delete traces;
+    delete feedback;
+}
+
+void ObjProto::trace(meow::memory::GCVisitor& visitor) {
+    if (chunk) chunk->trace(visitor);
+    visitor.visitObject(module);
+    for (const ExportSite& site : exportSites) visitor.visitObject(site.module);
+    if (feedback) feedback->trace(visitor);
+}
+
+ObjClosure::ObjClosure(Proto function) : proto(function), upvalueCount(function->upvalues) {
+    std::uninitialized_value_construct_n(upvalues(), upvalueCount);
+}
@@ -8,6 +8,7 @@
 
 #include "common/value.h"
 #include "common/definitions.h"
+#include "runtime/runtime_error.h"
 
 using namespace meow::common;
 
@@ -24,6 +25,10 @@ int64_t Value::asInt() const {
             return static_cast<int64_t>(f);
         },
         [](Bool b) -> int64_t { return b ? 1 : 0; },
+        // A BigInt never fits, clamping it would index or count with the wrong number
+        [](BigInt) -> int64_t {
+            throw meow::runtime::RuntimeError("integer too large");
+        },
         [](const String& s) -> int64_t {
             // By using std::string_view, it's make everything safe and faster
             std::string_view str = s->get();
@@ -132,6 +137,7 @@ double Value::asFloat() const {
         [](Int i) -> double { return static_cast<double>(i); },
         [](Float f) -> double { return f; },
         [](Bool b) -> double { return b ? 1.0 : 0.0; },
+        [](BigInt b) -> double { return b->get().toDouble(); },
         [](const String& s) -> double {
             std::string str = s->get();
 
@@ -174,8 +180,8 @@ bool Value::asBool() const {
             return f != 0.0 && !std::isnan(f);
         },
         [](Bool b) -> bool { return b; },
-        [](const Bytes& b) -> bool { !b->empty(); },
-        [](const String& s) -> bool { !s->empty(); },
+        [](const Bytes& b) -> bool { return !b->empty(); },
+        [](const String& s) -> bool { return !s->empty(); },
         [](const Array& a) -> bool { return !a->empty(); },
         [](const Object& o) -> bool { return !o->empty(); },
         [](auto&&) -> bool { return true; }
@@ -209,6 +215,7 @@ std::string Value::asString() const {
             return str.substr(0, end);
         },
         [](Bool b) -> std::string { return b ? "true" : "false"; },
+        [](BigInt b) -> std::string { return b->get().toString(); },
         [](String b) -> std::string { return b->get(); },
         [](const Array& a) -> std::string {
             std::string out = "[";
@@ -219,6 +226,11 @@ std::string Value::asString() const {
             out += "]";
             return out;
         },
+        [](Native n) -> std::string { return "<native " + n->name + ">"; },
+        [](Class c) -> std::string { return "<class " + c->name + ">"; },
+        [](Instance i) -> std::string { return "<" + i->klass->name + " instance>"; },
+        [](BoundMethod) -> std::string { return "<bound method>"; },
+        [](StringBuilder b) -> std::string { return b->buffer; },
         [](const Object& o) -> std::string {
             std::string out = "{";
             bool first = true;
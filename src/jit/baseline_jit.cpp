@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file baseline_jit.cpp
+ * @author lazypaws
+ * @brief Implementation of the MeowScript baseline template JIT
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/baseline_jit.h"
+#include "jit/assembler.h"
+#include "jit/jit_helpers.h"
+#include "runtime/chunk.h"
+#include "runtime/runtime_error.h"
+
+#include <cstddef>
+#include <type_traits>
+
+using namespace meow::jit;
+using namespace meow::common;
+using meow::runtime::RuntimeError;
+
+namespace {
+#ifdef MEOW_JIT_X86_64
+    // Where a Value keeps its payload and alternative index. The variant layout is up to the standard library,
+    // so it's read off real values: inline templates need the payload first and the index in a byte after it,
+    // otherwise every instruction calls its helper
+    struct ValueLayout {
+        bool inlinable = false;
+        int32_t index = 0;      // Offset of the index byte
+    };
+
+    template <typename T>
+    constexpr uint8_t INDEX_OF = static_cast<uint8_t>(BaseValue(T{}).index());
+
+    ValueLayout probeLayout() noexcept {
+        if (sizeof(Value) != 16 || !std::is_trivially_copyable_v<Value>) return {};
+        const Value probes[] = {Null{}, Int{0}, Float{0.0}, Bool{false}};
+        if (static_cast<const void*>(&probes[1].get<Int>()) != &probes[1]) return {};
+        for (int32_t offset = sizeof(Int); offset < static_cast<int32_t>(sizeof(Value)); ++offset) {
+            bool found = true;
+            for (const Value& probe : probes) {
+                found = found && reinterpret_cast<const uint8_t*>(&probe)[offset] == probe.index();
+            }
+            if (found) return {true, offset};
+        }
+        return {};
+    }
+
+    constexpr int32_t REGS = offsetof(JitContext, regs);
+    constexpr int32_t CONSTANTS = offsetof(JitContext, constants);
+
+    inline int32_t slot(uint32_t reg) noexcept {
+        return static_cast<int32_t>(reg * sizeof(Value));
+    }
+
+    // A guarded template's way out: the guards branch to a call of the instruction's helper, emitted after the code
+    struct SlowPath {
+        OpCode op;
+        uint32_t pc;
+        uint32_t operands[3];
+        std::vector<size_t> misses;     // Displacements of the guards
+        size_t resume = 0;              // Where the template ends
+    };
+
+    // Moves, loads and integer arithmetic are emitted inline, working on the register window loaded into rax.
+    // Arithmetic and comparisons check that both operands are Ints, and arithmetic that it didn't overflow
+    class InlineTemplates {
+    public:
+        InlineTemplates(Assembler& assembler, ValueLayout layout) : assembler(assembler), layout(layout) {}
+
+        // False if the instruction has no inline template, or values can't be accessed inline
+        bool emit(OpCode op, uint32_t pc, const uint32_t (&operands)[3]) {
+            if (!layout.inlinable) return false;
+            switch (op) {
+                case OpCode::MOVE:
+                    loadWindow();
+                    assembler.memory({0xF3, 0x0F, 0x6F}, 0, RAX, slot(operands[1]));     // movdqu xmm0, [rax + src]
+                    assembler.memory({0xF3, 0x0F, 0x7F}, 0, RAX, slot(operands[0]));     // movdqu [rax + dst], xmm0
+                    return true;
+                case OpCode::LOAD_CONST:
+                    assembler.memory({0x48, 0x8B}, RCX, RBX, CONSTANTS);                 // mov rcx, [rbx + constants]
+                    assembler.memory({0xF3, 0x0F, 0x6F}, 0, RCX, slot(operands[1]));     // movdqu xmm0, [rcx + index]
+                    loadWindow();
+                    assembler.memory({0xF3, 0x0F, 0x7F}, 0, RAX, slot(operands[0]));     // movdqu [rax + dst], xmm0
+                    return true;
+                case OpCode::LOAD_NULL:
+                    store(operands[0], 0, INDEX_OF<Null>);
+                    return true;
+                case OpCode::LOAD_TRUE:
+                    store(operands[0], 1, INDEX_OF<Bool>);
+                    return true;
+                case OpCode::LOAD_FALSE:
+                    store(operands[0], 0, INDEX_OF<Bool>);
+                    return true;
+                case OpCode::LOAD_INT:
+                    store(operands[0], (static_cast<uint64_t>(operands[2]) << 32) | operands[1], INDEX_OF<Int>);
+                    return true;
+                case OpCode::ADD: case OpCode::ADD_INT_INT:
+                    arithmetic(op, pc, operands, {0x48, 0x03});                         // add rcx, [rax + rhs]
+                    return true;
+                case OpCode::SUB: case OpCode::SUB_INT_INT:
+                    arithmetic(op, pc, operands, {0x48, 0x2B});                         // sub rcx, [rax + rhs]
+                    return true;
+                case OpCode::MUL: case OpCode::MUL_INT_INT:
+                    arithmetic(op, pc, operands, {0x48, 0x0F, 0xAF});                   // imul rcx, [rax + rhs]
+                    return true;
+                case OpCode::LT: case OpCode::LT_INT_INT:
+                    comparison(op, pc, operands, 0x9C);                                 // setl
+                    return true;
+                case OpCode::LE:
+                    comparison(op, pc, operands, 0x9E);                                 // setle
+                    return true;
+                case OpCode::GT:
+                    comparison(op, pc, operands, 0x9F);                                 // setg
+                    return true;
+                case OpCode::GE:
+                    comparison(op, pc, operands, 0x9D);                                 // setge
+                    return true;
+                case OpCode::EQ: case OpCode::EQ_INT_INT:
+                    comparison(op, pc, operands, 0x94);                                 // sete
+                    return true;
+                case OpCode::NEQ:
+                    comparison(op, pc, operands, 0x95);                                 // setne
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        std::vector<SlowPath> slowPaths;
+    private:
+        void loadWindow() {
+            assembler.memory({0x48, 0x8B}, RAX, RBX, REGS);                             // mov rax, [rbx + regs]
+        }
+
+        void tag(uint32_t dst, uint8_t index) {
+            assembler.memory({0xC6}, 0, RAX, slot(dst) + layout.index);                 // mov byte [rax + dst + index], tag
+            assembler.byte(index);
+        }
+
+        void store(uint32_t dst, uint64_t payload, uint8_t index) {
+            loadWindow();
+            assembler.byte(0x48); assembler.byte(0xB9); assembler.imm64(payload);      // mov rcx, payload
+            assembler.memory({0x48, 0x89}, RCX, RAX, slot(dst));                        // mov [rax + dst], rcx
+            tag(dst, index);
+        }
+
+        // Loads the left operand into rcx once both operands are known to be Ints
+        SlowPath guardInts(OpCode op, uint32_t pc, const uint32_t (&operands)[3]) {
+            SlowPath path{op, pc, {operands[0], operands[1], operands[2]}, {}};
+            loadWindow();
+            for (uint32_t reg : {operands[1], operands[2]}) {
+                assembler.memory({0x80}, 7, RAX, slot(reg) + layout.index);             // cmp byte [rax + reg + index], int
+                assembler.byte(INDEX_OF<Int>);
+                path.misses.push_back(assembler.branch({0x0F, 0x85}));                  // jne slow
+            }
+            assembler.memory({0x48, 0x8B}, RCX, RAX, slot(operands[1]));                // mov rcx, [rax + lhs]
+            return path;
+        }
+
+        void arithmetic(OpCode op, uint32_t pc, const uint32_t (&operands)[3], std::initializer_list<uint8_t> opcode) {
+            SlowPath path = guardInts(op, pc, operands);
+            assembler.memory(opcode, RCX, RAX, slot(operands[2]));
+            path.misses.push_back(assembler.branch({0x0F, 0x80}));                      // jo slow
+            assembler.memory({0x48, 0x89}, RCX, RAX, slot(operands[0]));                // mov [rax + dst], rcx
+            tag(operands[0], INDEX_OF<Int>);
+            path.resume = assembler.here();
+            slowPaths.push_back(std::move(path));
+        }
+
+        void comparison(OpCode op, uint32_t pc, const uint32_t (&operands)[3], uint8_t setcc) {
+            SlowPath path = guardInts(op, pc, operands);
+            assembler.memory({0x48, 0x3B}, RCX, RAX, slot(operands[2]));                // cmp rcx, [rax + rhs]
+            assembler.byte(0x0F); assembler.byte(setcc); assembler.byte(0xC2);          // setcc dl
+            assembler.byte(0x0F); assembler.byte(0xB6); assembler.byte(0xD2);           // movzx edx, dl
+            assembler.memory({0x48, 0x89}, RDX, RAX, slot(operands[0]));                // mov [rax + dst], rdx
+            tag(operands[0], INDEX_OF<Bool>);
+            path.resume = assembler.here();
+            slowPaths.push_back(std::move(path));
+        }
+
+        Assembler& assembler;
+        ValueLayout layout;
+    };
+#endif
+}
+
+NativeCode::NativeCode(const std::vector<uint8_t>& code, std::vector<uint32_t> entries) : block(code), entries(std::move(entries)) {}
+
+size_t NativeCode::run(JitContext& context, size_t pc) const noexcept {
+    // The code is entered through its prologue, which jumps to the instruction's template
+    using Entry = uint32_t (*)(JitContext*, const void*);
+    auto entry = reinterpret_cast<Entry>(const_cast<uint8_t*>(block.data()));
+    return entry(&context, block.data() + entries[pc]) - 1;
+}
+
+bool meow::jit::isSupported() noexcept {
+#ifdef MEOW_JIT_X86_64
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::unique_ptr<CompiledCode> meow::jit::compileBaseline(const ObjProto& proto) {
+#ifdef MEOW_JIT_X86_64
+    const uint8_t* code = proto.chunk->data();
+    size_t size = proto.chunk->size();
+
+    static const ValueLayout layout = probeLayout();
+    Assembler assembler;
+    InlineTemplates templates(assembler, layout);
+    std::vector<uint32_t> entries(size, NativeCode::NO_ENTRY);
+    std::vector<std::pair<size_t, size_t>> jumps;       // (displacement, bytecode target)
+    std::vector<size_t> exits;                          // Displacements branching to the epilogue
+
+    // Prologue: keep the context in a callee-saved register, then jump to the entry template
+    assembler.byte(0x53);                                           // push rbx
+    assembler.byte(0x48); assembler.byte(0x89); assembler.byte(0xFB);   // mov rbx, rdi
+    assembler.byte(0xFF); assembler.byte(0xE6);                     // jmp rsi
+
+    for (size_t pc = 0; pc < size;) {
+        OpCode op = static_cast<OpCode>(code[pc]);
+        entries[pc] = static_cast<uint32_t>(assembler.here());
+        uint32_t at = static_cast<uint32_t>(pc);
+        uint32_t operands[3];
+        decodeOperands(code, pc, operands);
+
+        switch (op) {
+            case OpCode::JUMP:
+                jumps.emplace_back(assembler.branch({0xE9}), operands[0]);                      // jmp target
+                break;
+            case OpCode::JUMP_IF_FALSE:
+            case OpCode::JUMP_IF_TRUE:
+                assembler.call(truthy, at, operands[0], 0, 0);
+                jumps.emplace_back(assembler.branch({0x0F, static_cast<uint8_t>(op == OpCode::JUMP_IF_FALSE ? 0x84 : 0x85)}), operands[1]);
+                break;
+            case OpCode::FORLOOP:
+                assembler.call(forLoop, at, operands[0], 0, 0);
+                jumps.emplace_back(assembler.branch({0x0F, 0x85}), operands[1]);               // jnz body
+                break;
+            // Exception table markers do nothing at run time
+            case OpCode::SETUP_TRY:
+            case OpCode::POP_TRY:
+                break;
+            default:
+                if (templates.emit(op, at, operands)) break;
+                if (Helper helper = helperFor(op)) {
+                    assembler.call(helper, at, operands[0], operands[1], operands[2]);
+                    exits.push_back(assembler.branch({0x0F, 0x85}));                        // jnz epilogue
+                } else {
+                    assembler.byte(0xB8); assembler.imm32(at + 1);                          // mov eax, pc + 1
+                    exits.push_back(assembler.branch({0xE9}));                              // jmp epilogue
+                }
+                break;
+        }
+        pc += instructionSize(op);
+    }
+
+    // Running off the end of the code resumes the interpreter there, which reports it
+    assembler.byte(0xB8); assembler.imm32(static_cast<uint32_t>(size) + 1);
+    size_t epilogue = assembler.here();
+    assembler.byte(0x5B);                                           // pop rbx
+    assembler.byte(0xC3);                                           // ret
+
+    // Guard failures call the helper, which handles every case, and continue after the template
+    for (const SlowPath& path : templates.slowPaths) {
+        for (size_t miss : path.misses) assembler.patch(miss, assembler.here());
+        assembler.call(helperFor(path.op), path.pc, path.operands[0], path.operands[1], path.operands[2]);
+        exits.push_back(assembler.branch({0x0F, 0x85}));                                   // jnz epilogue
+        assembler.patch(assembler.branch({0xE9}), path.resume);                             // jmp back
+    }
+
+    for (size_t exit : exits) {
+        assembler.patch(exit, epilogue);
+    }
+    for (auto [displacement, target] : jumps) {
+        if (target >= size || entries[target] == NativeCode::NO_ENTRY) {
+            throw RuntimeError("jump into the middle of an instruction at offset " + std::to_string(target));
+        }
+        assembler.patch(displacement, entries[target]);
+    }
+
+    return std::make_unique<NativeCode>(assembler.bytes, std::move(entries));
+#else
+    (void)proto;
+    return nullptr;
+#endif
+}
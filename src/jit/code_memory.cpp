@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file code_memory.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript executable memory
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/code_memory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace meow::jit;
+
+CodeBlock::CodeBlock(const std::vector<uint8_t>& code) : memory(nullptr), codeSize(code.size()) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t page = info.dwPageSize;
+#else
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    mappedSize = std::max<size_t>(1, (code.size() + page - 1) / page) * page;
+
+#ifdef _WIN32
+    memory = static_cast<uint8_t*>(VirtualAlloc(nullptr, mappedSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    if (!memory) throw std::bad_alloc();
+    std::memcpy(memory, code.data(), code.size());
+    DWORD previous;
+    if (!VirtualProtect(memory, mappedSize, PAGE_EXECUTE_READ, &previous)) {
+        VirtualFree(memory, 0, MEM_RELEASE);
+        throw std::bad_alloc();
+    }
+    FlushInstructionCache(GetCurrentProcess(), memory, codeSize);
+#else
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) throw std::bad_alloc();
+    memory = static_cast<uint8_t*>(mapped);
+    std::memcpy(memory, code.data(), code.size());
+    if (mprotect(memory, mappedSize, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, mappedSize);
+        throw std::bad_alloc();
+    }
+    __builtin___clear_cache(reinterpret_cast<char*>(memory), reinterpret_cast<char*>(memory + codeSize));
+#endif
+}
+
+CodeBlock::~CodeBlock() {
+#ifdef _WIN32
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, mappedSize);
+#endif
+}
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file compiled_code.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript JIT backend selection
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/compiled_code.h"
+#include "jit/baseline_jit.h"
+#include "jit/threaded_code.h"
+
+using namespace meow::jit;
+
+Backend meow::jit::defaultBackend() noexcept {
+    return isSupported() ? Backend::NATIVE : Backend::THREADED;
+}
+
+std::unique_ptr<CompiledCode> meow::jit::compile(const meow::common::ObjProto& proto, Backend backend) {
+    switch (backend) {
+        case Backend::NATIVE: return compileBaseline(proto);
+        case Backend::THREADED: return compileThreaded(proto);
+    }
+    return nullptr;
+}
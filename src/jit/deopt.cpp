@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file deopt.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript deoptimization bookkeeping
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/deopt.h"
+#include "runtime/feedback.h"
+
+using namespace meow::jit;
+using namespace meow::common;
+
+bool meow::jit::maySpeculate(const ObjProto& proto, uint32_t pc) noexcept {
+    return !proto.feedback || proto.feedback->deopts(pc) < MAX_SITE_DEOPTS;
+}
+
+void meow::jit::recordDeopt(ObjProto& proto, uint32_t pc) {
+    if (!proto.feedback) proto.feedback = new meow::runtime::FeedbackVector(proto);
+    proto.feedback->recordDeopt(pc);
+}
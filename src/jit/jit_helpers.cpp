@@ -0,0 +1,282 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file jit_helpers.cpp
+ * @author lazypaws
+ * @brief Implementation of the MeowScript JIT instruction helpers
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/jit_helpers.h"
+#include "memory/memory_manager.h"
+#include "runtime/native.h"
+#include "runtime/operators.h"
+#include "runtime/runtime_error.h"
+
+using namespace meow::jit;
+using namespace meow::common;
+using meow::runtime::RuntimeError;
+namespace operators = meow::runtime::operators;
+
+namespace {
+    using Body = void (*)(JitContext&, uint32_t, uint32_t, uint32_t);
+
+    template <Body body>
+    uint32_t guarded(JitContext* context, uint32_t pc, uint32_t a, uint32_t b, uint32_t c) noexcept {
+        try {
+            body(*context, a, b, c);
+            return 0;
+        } catch (...) {
+            context->pending = std::current_exception();
+            return pc + 1;
+        }
+    }
+
+    void loadConst(JitContext& context, uint32_t dst, uint32_t index, uint32_t) {
+        context.regs[dst] = context.constants[index];
+    }
+    void loadNull(JitContext& context, uint32_t dst, uint32_t, uint32_t) {
+        context.regs[dst] = Null{};
+    }
+    void loadTrue(JitContext& context, uint32_t dst, uint32_t, uint32_t) {
+        context.regs[dst] = true;
+    }
+    void loadFalse(JitContext& context, uint32_t dst, uint32_t, uint32_t) {
+        context.regs[dst] = false;
+    }
+    // The 64-bit immediate is split across two operands
+    void loadInt(JitContext& context, uint32_t dst, uint32_t low, uint32_t high) {
+        context.regs[dst] = static_cast<Int>((static_cast<uint64_t>(high) << 32) | low);
+    }
+    void move(JitContext& context, uint32_t dst, uint32_t src, uint32_t) {
+        context.regs[dst] = context.regs[src];
+    }
+
+    void getGlobal(JitContext& context, uint32_t dst, uint32_t slot, uint32_t) {
+        const GlobalCell& cell = context.globals->cell(slot);
+        if (!cell.defined) {
+            throw RuntimeError("undefined global '" + context.globals->globalName(slot) + "'");
+        }
+        context.regs[dst] = cell.value;
+    }
+    void setGlobal(JitContext& context, uint32_t slot, uint32_t src, uint32_t) {
+        context.globals->cell(slot).assign(context.regs[src]);
+    }
+    void getUpvalue(JitContext& context, uint32_t dst, uint32_t index, uint32_t) {
+        context.regs[dst] = context.closure->getUpvalue(index);
+    }
+    void setUpvalue(JitContext& context, uint32_t index, uint32_t src, uint32_t) {
+        context.closure->setUpvalue(index, context.regs[src]);
+    }
+
+    template <Value (*op)(meow::memory::MemoryManager&, const Value&, const Value&)>
+    void heapBinary(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        context.regs[dst] = op(*context.heap, context.regs[a], context.regs[b]);
+    }
+    // s = s + x may append in place, as in the interpreter
+    void add(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        Value* regs = context.regs;
+        if (dst == a && regs[a].is<String>()) regs[dst] = operators::append(*context.heap, regs[a].get<String>(), regs[b]);
+        else regs[dst] = operators::add(*context.heap, regs[a], regs[b]);
+    }
+    template <Value (*op)(const Value&, const Value&)>
+    void binary(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        context.regs[dst] = op(context.regs[a], context.regs[b]);
+    }
+    template <bool (*op)(const Value&, const Value&), bool swapped, bool negated>
+    void compare(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        bool result = swapped ? op(context.regs[b], context.regs[a]) : op(context.regs[a], context.regs[b]);
+        context.regs[dst] = result != negated;
+    }
+    void negate(JitContext& context, uint32_t dst, uint32_t src, uint32_t) {
+        context.regs[dst] = operators::negate(*context.heap, context.regs[src]);
+    }
+    void logicalNot(JitContext& context, uint32_t dst, uint32_t src, uint32_t) {
+        context.regs[dst] = !context.regs[src].asBool();
+    }
+    void bitNot(JitContext& context, uint32_t dst, uint32_t src, uint32_t) {
+        context.regs[dst] = operators::bitNot(*context.heap, context.regs[src]);
+    }
+
+    // Quickened instructions keep their guard, a miss takes the generic path without de-specializing
+    template <bool (*overflow)(Int, Int, Int*), Value (*generic)(meow::memory::MemoryManager&, const Value&, const Value&)>
+    void intArithmetic(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        Value* regs = context.regs;
+        Int result;
+        if (regs[a].is<Int>() && regs[b].is<Int>() && !overflow(regs[a].get<Int>(), regs[b].get<Int>(), &result)) [[likely]] {
+            regs[dst] = result;
+        } else {
+            regs[dst] = generic(*context.heap, regs[a], regs[b]);
+        }
+    }
+    bool addOverflow(Int a, Int b, Int* result) { return __builtin_add_overflow(a, b, result); }
+    bool subOverflow(Int a, Int b, Int* result) { return __builtin_sub_overflow(a, b, result); }
+    bool mulOverflow(Int a, Int b, Int* result) { return __builtin_mul_overflow(a, b, result); }
+
+    template <Float (*op)(Float, Float), Value (*generic)(meow::memory::MemoryManager&, const Value&, const Value&)>
+    void floatArithmetic(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        Value* regs = context.regs;
+        if (regs[a].is<Float>() && regs[b].is<Float>()) [[likely]] {
+            regs[dst] = op(regs[a].get<Float>(), regs[b].get<Float>());
+        } else {
+            regs[dst] = generic(*context.heap, regs[a], regs[b]);
+        }
+    }
+    Float addFloat(Float a, Float b) { return a + b; }
+    Float subFloat(Float a, Float b) { return a - b; }
+    Float mulFloat(Float a, Float b) { return a * b; }
+
+    void lessIntInt(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        Value* regs = context.regs;
+        if (regs[a].is<Int>() && regs[b].is<Int>()) [[likely]] regs[dst] = regs[a].get<Int>() < regs[b].get<Int>();
+        else regs[dst] = operators::lessThan(regs[a], regs[b]);
+    }
+    void lessFloatFloat(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        Value* regs = context.regs;
+        if (regs[a].is<Float>() && regs[b].is<Float>()) [[likely]] regs[dst] = regs[a].get<Float>() < regs[b].get<Float>();
+        else regs[dst] = operators::lessThan(regs[a], regs[b]);
+    }
+    void equalIntInt(JitContext& context, uint32_t dst, uint32_t a, uint32_t b) {
+        Value* regs = context.regs;
+        if (regs[a].is<Int>() && regs[b].is<Int>()) [[likely]] regs[dst] = regs[a].get<Int>() == regs[b].get<Int>();
+        else regs[dst] = operators::equals(regs[a], regs[b]);
+    }
+
+    void newArray(JitContext& context, uint32_t dst, uint32_t start, uint32_t count) {
+        Value* regs = context.regs;
+        regs[dst] = context.heap->newObject<ObjArray>(std::vector<Value>(regs + start, regs + start + count));
+    }
+    void newHash(JitContext& context, uint32_t dst, uint32_t start, uint32_t count) {
+        Value* regs = context.regs;
+        Object object = context.heap->newObject<ObjHash>();
+        for (uint32_t i = 0; i < count; ++i) {
+            operators::setIndex(object, regs[start + 2 * i], regs[start + 2 * i + 1]);
+        }
+        regs[dst] = object;
+    }
+    void getIndex(JitContext& context, uint32_t dst, uint32_t src, uint32_t key) {
+        context.regs[dst] = operators::getIndex(*context.heap, context.regs[src], context.regs[key]);
+    }
+    void getIndexArrayInt(JitContext& context, uint32_t dst, uint32_t src, uint32_t key) {
+        Value* regs = context.regs;
+        if (regs[src].is<Array>() && regs[key].is<Int>()) [[likely]] {
+            Array array = regs[src].get<Array>();
+            uint64_t index = static_cast<uint64_t>(regs[key].get<Int>());
+            if (index < array->size()) [[likely]] {
+                regs[dst] = array->get(index);
+                return;
+            }
+        }
+        regs[dst] = operators::getIndex(*context.heap, regs[src], regs[key]);
+    }
+    void setIndex(JitContext& context, uint32_t src, uint32_t key, uint32_t value) {
+        operators::setIndex(context.regs[src], context.regs[key], context.regs[value]);
+    }
+
+    // Natives run on the caller's registers, so compiled code calls them in place.
+    // Calls to anything else push a frame, which only the interpreter does
+    uint32_t call(JitContext* context, uint32_t pc, uint32_t dst, uint32_t fn, uint32_t argc) noexcept {
+        const Native* target = context->regs[fn].get_if<Native>();
+        if (!target) return pc + 1;
+        try {
+            meow::runtime::checkArguments(**target, context->regs + fn + 1, argc);
+            Value result = (*target)->function(*context->heap, context->regs + fn + 1);
+            context->regs[dst] = std::move(result);
+            return 0;
+        } catch (...) {
+            context->pending = std::current_exception();
+            return pc + 1;
+        }
+    }
+    // Only natives run in place, the RETURN after them exits anyway
+    uint32_t tailCall(JitContext* context, uint32_t pc, uint32_t fn, uint32_t argc, uint32_t) noexcept {
+        return call(context, pc, fn, fn, argc);
+    }
+}
+
+Helper meow::jit::helperFor(OpCode op) noexcept {
+    switch (op) {
+        case OpCode::LOAD_CONST: return guarded<loadConst>;
+        case OpCode::LOAD_NULL: return guarded<loadNull>;
+        case OpCode::LOAD_TRUE: return guarded<loadTrue>;
+        case OpCode::LOAD_FALSE: return guarded<loadFalse>;
+        case OpCode::LOAD_INT: return guarded<loadInt>;
+        case OpCode::MOVE: return guarded<move>;
+        case OpCode::GET_GLOBAL: return guarded<getGlobal>;
+        case OpCode::SET_GLOBAL: return guarded<setGlobal>;
+        case OpCode::GET_UPVALUE: return guarded<getUpvalue>;
+        case OpCode::SET_UPVALUE: return guarded<setUpvalue>;
+
+        case OpCode::ADD: return guarded<add>;
+        case OpCode::SUB: return guarded<heapBinary<operators::subtract>>;
+        case OpCode::MUL: return guarded<heapBinary<operators::multiply>>;
+        case OpCode::DIV: return guarded<binary<operators::divide>>;
+        case OpCode::MOD: return guarded<heapBinary<operators::modulo>>;
+        case OpCode::POW: return guarded<heapBinary<operators::power>>;
+        case OpCode::EQ: return guarded<compare<operators::equals, false, false>>;
+        case OpCode::NEQ: return guarded<compare<operators::equals, false, true>>;
+        case OpCode::GT: return guarded<compare<operators::lessThan, true, false>>;
+        case OpCode::GE: return guarded<compare<operators::lessEqual, true, false>>;
+        case OpCode::LT: return guarded<compare<operators::lessThan, false, false>>;
+        case OpCode::LE: return guarded<compare<operators::lessEqual, false, false>>;
+        case OpCode::NEG: return guarded<negate>;
+        case OpCode::NOT: return guarded<logicalNot>;
+        case OpCode::BIT_AND: return guarded<heapBinary<operators::bitAnd>>;
+        case OpCode::BIT_OR: return guarded<heapBinary<operators::bitOr>>;
+        case OpCode::BIT_XOR: return guarded<heapBinary<operators::bitXor>>;
+        case OpCode::BIT_NOT: return guarded<bitNot>;
+        case OpCode::LSHIFT: return guarded<heapBinary<operators::shiftLeft>>;
+        case OpCode::RSHIFT: return guarded<heapBinary<operators::shiftRight>>;
+
+        case OpCode::NEW_ARRAY: return guarded<newArray>;
+        case OpCode::NEW_HASH: return guarded<newHash>;
+        case OpCode::GET_INDEX: return guarded<getIndex>;
+        case OpCode::SET_INDEX: return guarded<setIndex>;
+        case OpCode::CALL: return call;
+        case OpCode::TAIL_CALL: return tailCall;
+
+        case OpCode::ADD_INT_INT: return guarded<intArithmetic<addOverflow, operators::add>>;
+        case OpCode::SUB_INT_INT: return guarded<intArithmetic<subOverflow, operators::subtract>>;
+        case OpCode::MUL_INT_INT: return guarded<intArithmetic<mulOverflow, operators::multiply>>;
+        case OpCode::ADD_FLOAT_FLOAT: return guarded<floatArithmetic<addFloat, operators::add>>;
+        case OpCode::SUB_FLOAT_FLOAT: return guarded<floatArithmetic<subFloat, operators::subtract>>;
+        case OpCode::MUL_FLOAT_FLOAT: return guarded<floatArithmetic<mulFloat, operators::multiply>>;
+        case OpCode::LT_INT_INT: return guarded<lessIntInt>;
+        case OpCode::LT_FLOAT_FLOAT: return guarded<lessFloatFloat>;
+        case OpCode::EQ_INT_INT: return guarded<equalIntInt>;
+        case OpCode::GET_INDEX_ARRAY_INT: return guarded<getIndexArrayInt>;
+
+        default: return nullptr;
+    }
+}
+
+uint32_t meow::jit::truthy(JitContext* context, uint32_t, uint32_t cond, uint32_t, uint32_t) noexcept {
+    return context->regs[cond].asBool();
+}
+
+uint32_t meow::jit::forLoop(JitContext* context, uint32_t, uint32_t a, uint32_t, uint32_t) noexcept {
+    Value* regs = context->regs;
+    uint64_t left = static_cast<uint64_t>(regs[a + 1].get<Int>());
+    if (left == 0) return 0;
+    Int index = static_cast<Int>(static_cast<uint64_t>(regs[a].get<Int>()) + static_cast<uint64_t>(regs[a + 2].get<Int>()));
+    regs[a] = index;
+    regs[a + 1] = static_cast<Int>(left - 1);
+    regs[a + 3] = index;
+    return 1;
+}
+
+void meow::jit::decodeOperands(const uint8_t* code, size_t pc, uint32_t (&operands)[3]) noexcept {
+    OpCode op = static_cast<OpCode>(code[pc]);
+    operands[0] = operands[1] = operands[2] = 0;
+    if (op == OpCode::LOAD_INT) {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(code[pc + 3 + i]) << (i * 8);
+        operands[0] = static_cast<uint32_t>(code[pc + 1] | (code[pc + 2] << 8));
+        operands[1] = static_cast<uint32_t>(value);
+        operands[2] = static_cast<uint32_t>(value >> 32);
+        return;
+    }
+    size_t count = (instructionSize(op) - 1) / 2;
+    for (size_t i = 0; i < count && i < 3; ++i) {
+        operands[i] = static_cast<uint32_t>(code[pc + 1 + 2 * i] | (code[pc + 2 + 2 * i] << 8));
+    }
+}
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file threaded_code.cpp
+ * @author lazypaws
+ * @brief Implementation of the MeowScript threaded-code backend
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/threaded_code.h"
+#include "runtime/chunk.h"
+#include "runtime/runtime_error.h"
+
+using namespace meow::jit;
+using namespace meow::common;
+using meow::runtime::RuntimeError;
+
+ThreadedCode::ThreadedCode(std::vector<Step> steps, std::vector<uint32_t> entries) : steps(std::move(steps)), entries(std::move(entries)) {}
+
+size_t ThreadedCode::run(JitContext& context, size_t pc) const noexcept {
+    const Step* base = steps.data();
+    const Step* step = base + entries[pc];
+    for (;;) {
+        switch (step->kind) {
+            case Kind::HELPER:
+                if (uint32_t exit = step->helper(&context, step->pc, step->operands[0], step->operands[1], step->operands[2])) [[unlikely]] {
+                    return exit - 1;
+                }
+                ++step;
+                break;
+            case Kind::JUMP:
+                step = base + step->target;
+                break;
+            case Kind::JUMP_IF_FALSE:
+                step = context.regs[step->operands[0]].asBool() ? step + 1 : base + step->target;
+                break;
+            case Kind::JUMP_IF_TRUE:
+                step = context.regs[step->operands[0]].asBool() ? base + step->target : step + 1;
+                break;
+            case Kind::FOR_LOOP:
+                step = forLoop(&context, step->pc, step->operands[0], 0, 0) ? base + step->target : step + 1;
+                break;
+            case Kind::EXIT:
+                return step->pc;
+        }
+    }
+}
+
+std::unique_ptr<CompiledCode> meow::jit::compileThreaded(const ObjProto& proto) {
+    using Step = ThreadedCode::Step;
+    using Kind = ThreadedCode::Kind;
+    constexpr uint32_t NO_ENTRY = ThreadedCode::NO_ENTRY;
+
+    const uint8_t* code = proto.chunk->data();
+    size_t size = proto.chunk->size();
+
+    std::vector<Step> steps;
+    std::vector<uint32_t> entries(size, NO_ENTRY);
+    steps.reserve(size / 3 + 1);
+
+    for (size_t pc = 0; pc < size;) {
+        OpCode op = static_cast<OpCode>(code[pc]);
+        entries[pc] = static_cast<uint32_t>(steps.size());
+
+        Step step{Kind::HELPER, nullptr, static_cast<uint32_t>(pc), {0, 0, 0}, 0};
+        decodeOperands(code, pc, step.operands);
+        switch (op) {
+            case OpCode::JUMP:
+                step.kind = Kind::JUMP;
+                step.target = step.operands[0];     // Bytecode offset until patched below
+                steps.push_back(step);
+                break;
+            case OpCode::JUMP_IF_FALSE:
+            case OpCode::JUMP_IF_TRUE:
+                step.kind = op == OpCode::JUMP_IF_FALSE ? Kind::JUMP_IF_FALSE : Kind::JUMP_IF_TRUE;
+                step.target = step.operands[1];
+                steps.push_back(step);
+                break;
+            case OpCode::FORLOOP:
+                step.kind = Kind::FOR_LOOP;
+                step.target = step.operands[1];
+                steps.push_back(step);
+                break;
+            // Exception table markers do nothing at run time, they start at the next step
+            case OpCode::SETUP_TRY:
+            case OpCode::POP_TRY:
+                break;
+            default:
+                step.helper = helperFor(op);
+                if (!step.helper) step.kind = Kind::EXIT;
+                steps.push_back(step);
+                break;
+        }
+        pc += instructionSize(op);
+    }
+    // Running off the end of the code resumes the interpreter there, which reports it
+    steps.push_back(Step{Kind::EXIT, nullptr, static_cast<uint32_t>(size), {0, 0, 0}, 0});
+
+    for (Step& step : steps) {
+        if (step.kind == Kind::HELPER || step.kind == Kind::EXIT) continue;
+        if (step.target >= size || entries[step.target] == NO_ENTRY) {
+            throw RuntimeError("jump into the middle of an instruction at offset " + std::to_string(step.target));
+        }
+        step.target = entries[step.target];
+    }
+
+    return std::make_unique<ThreadedCode>(std::move(steps), std::move(entries));
+}
@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file trace.cpp
+ * @author lazypaws
+ * @brief Implementation of the MeowScript trace executor
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/trace.h"
+
+using namespace meow::jit;
+using namespace meow::common;
+
+namespace {
+    // Traces with more live values than this spill their slots to the heap
+    constexpr size_t INLINE_SLOTS = 64;
+
+    inline bool truth(const Slot& slot, IrType type) noexcept {
+        switch (type) {
+            case IrType::INT: return slot.i != 0;
+            case IrType::FLOAT: return slot.f != 0.0 && !std::isnan(slot.f);
+            case IrType::BOOL: return slot.b;
+            case IrType::ARRAY: return slot.array->size() != 0;
+            default: return false;
+        }
+    }
+
+    template <typename T>
+    inline bool compare(IrOp op, T lhs, T rhs) noexcept {
+        switch (op) {
+            case IrOp::LT: return lhs < rhs;
+            case IrOp::LE: return lhs <= rhs;
+            case IrOp::EQ: return lhs == rhs;
+            default: return lhs != rhs;
+        }
+    }
+
+    const char* opName(IrOp op) noexcept {
+        static constexpr const char* names[] = {
+            "LOAD", "GLOBAL", "CONST", "PHI", "TO_FLOAT", "ADD", "SUB", "MUL", "DIV", "NEG",
+            "LT", "LE", "EQ", "NE", "NOT", "GUARD_TRUE", "GUARD_FALSE", "ARRAY_GET", "ARRAY_SET"
+        };
+        return names[static_cast<size_t>(op)];
+    }
+
+    const char* typeName(IrType type) noexcept {
+        static constexpr const char* names[] = {"int", "float", "bool", "array", "-"};
+        return names[static_cast<size_t>(type)];
+    }
+}
+
+size_t Trace::execute(JitContext& context, Slot* slots, bool& iterated) const noexcept {
+    Value* regs = context.regs;
+    const IrInstr* instrs = code.data();
+    const IrInstr* instr = instrs;
+    const IrInstr* stop = instrs + loopStart;
+    iterated = false;
+
+    for (;;) {
+        for (; instr != stop; ++instr) {
+            Slot& out = slots[instr->slot];
+            switch (instr->op) {
+                case IrOp::LOAD:
+                    if (!unbox(regs[instr->imm], instr->type, out)) [[unlikely]] goto leave;
+                    break;
+                case IrOp::GLOBAL: {
+                    const GlobalCell& cell = context.globals->cell(static_cast<size_t>(instr->imm));
+                    if (!cell.defined || !unbox(cell.value, instr->type, out)) [[unlikely]] goto leave;
+                    break;
+                }
+                case IrOp::CONST:
+                    out.i = instr->imm;
+                    break;
+                case IrOp::PHI:
+                    // Phis are only assigned on entry and at the back-edge
+                    break;
+                case IrOp::TO_FLOAT:
+                    out.f = static_cast<double>(slots[instr->operandSlots[0]].i);
+                    break;
+
+                case IrOp::ADD: case IrOp::SUB: case IrOp::MUL: case IrOp::DIV: {
+                    const Slot& lhs = slots[instr->operandSlots[0]];
+                    const Slot& rhs = slots[instr->operandSlots[1]];
+                    if (instr->type == IrType::INT) {
+                        int64_t result;
+                        bool overflow = instr->op == IrOp::ADD ? __builtin_add_overflow(lhs.i, rhs.i, &result)
+                                      : instr->op == IrOp::SUB ? __builtin_sub_overflow(lhs.i, rhs.i, &result)
+                                      : __builtin_mul_overflow(lhs.i, rhs.i, &result);
+                        if (overflow) [[unlikely]] goto leave;
+                        out.i = result;
+                    } else {
+                        double x = lhs.f, y = rhs.f;
+                        out.f = instr->op == IrOp::ADD ? x + y : instr->op == IrOp::SUB ? x - y : instr->op == IrOp::MUL ? x * y : x / y;
+                    }
+                    break;
+                }
+                case IrOp::NEG: {
+                    const Slot& value = slots[instr->operandSlots[0]];
+                    if (instr->type == IrType::INT) {
+                        int64_t result;
+                        if (__builtin_sub_overflow(int64_t{0}, value.i, &result)) [[unlikely]] goto leave;
+                        out.i = result;
+                    } else {
+                        out.f = -value.f;
+                    }
+                    break;
+                }
+                case IrOp::LT: case IrOp::LE: case IrOp::EQ: case IrOp::NE: {
+                    const Slot& lhs = slots[instr->operandSlots[0]];
+                    const Slot& rhs = slots[instr->operandSlots[1]];
+                    if (instr->operand == IrType::INT) out.b = compare(instr->op, lhs.i, rhs.i);
+                    else if (instr->operand == IrType::FLOAT) out.b = compare(instr->op, lhs.f, rhs.f);
+                    else out.b = compare(instr->op, lhs.b, rhs.b);
+                    break;
+                }
+                case IrOp::NOT:
+                    out.b = !truth(slots[instr->operandSlots[0]], instrs[instr->a].type);
+                    break;
+
+                case IrOp::GUARD_TRUE:
+                    if (!truth(slots[instr->operandSlots[0]], instrs[instr->a].type)) goto leave;
+                    break;
+                case IrOp::GUARD_FALSE:
+                    if (truth(slots[instr->operandSlots[0]], instrs[instr->a].type)) goto leave;
+                    break;
+
+                case IrOp::ARRAY_GET: {
+                    ObjArray* array = slots[instr->operandSlots[0]].array;
+                    uint64_t index = static_cast<uint64_t>(slots[instr->operandSlots[1]].i);
+                    if (index >= array->size() || !unbox(array->get(index), instr->type, out)) [[unlikely]] goto leave;
+                    break;
+                }
+                case IrOp::ARRAY_SET: {
+                    ObjArray* array = slots[instr->operandSlots[0]].array;
+                    uint64_t index = static_cast<uint64_t>(slots[instr->operandSlots[1]].i);
+                    if (index >= array->size()) [[unlikely]] goto leave;
+                    array->set(index, box(slots[instr->operandSlots[2]], instrs[instr->c].type));
+                    break;
+                }
+            }
+        }
+
+        if (stop == instrs + loopStart) {
+            // Entering the loop: every phi starts from its value on entry
+            for (size_t phi = loopStart; phi < bodyStart; ++phi) {
+                slots[instrs[phi].slot] = slots[instrs[phi].operandSlots[0]];
+            }
+        } else {
+            // Back-edge: the loop-carried values move into their phis all at once
+            size_t moves = backEdgeMoves.size();
+            if (moves == 1) {
+                slots[backEdgeMoves[0].first] = slots[backEdgeMoves[0].second];
+            } else if (moves) {
+                Slot inlineCarried[INLINE_SLOTS];
+                std::vector<Slot> spilledCarried(moves > INLINE_SLOTS ? moves : 0);
+                Slot* carried = moves > INLINE_SLOTS ? spilledCarried.data() : inlineCarried;
+                for (size_t move = 0; move < moves; ++move) carried[move] = slots[backEdgeMoves[move].second];
+                for (size_t move = 0; move < moves; ++move) slots[backEdgeMoves[move].first] = carried[move];
+            }
+            iterated = true;
+        }
+        instr = instrs + bodyStart;
+        stop = instrs + code.size();
+    }
+
+leave:
+    return static_cast<size_t>(instr - instrs);
+}
+
+size_t Trace::run(JitContext& context) noexcept {
+    // Machine code also needs a slot to break cycles of back-edge moves and one telling if the loop went around
+    size_t count = slotCount + 2;
+    Slot inlineSlots[INLINE_SLOTS];
+    std::unique_ptr<Slot[]> spilled;
+    Slot* slots = inlineSlots;
+    if (count > INLINE_SLOTS) {
+        spilled.reset(new (std::nothrow) Slot[count]);
+        if (!spilled) return header;
+        slots = spilled.get();
+    }
+
+    size_t exit;
+    bool iterated;
+    if (machineCode) {
+        using Entry = uint32_t (*)(JitContext*, Slot*);
+        auto entry = reinterpret_cast<Entry>(const_cast<uint8_t*>(machineCode->data()));
+        slots[slotCount + 1].i = 0;
+        exit = entry(&context, slots);
+        iterated = slots[slotCount + 1].i != 0;
+    } else {
+        exit = execute(context, slots, iterated);
+    }
+
+    // Leaves the trace, boxing the registers the snapshot says are out of date
+    const Snapshot& snapshot = snapshots[code[exit].snapshot];
+    for (auto [reg, ref] : snapshot.registers) {
+        context.regs[reg] = box(slots[code[ref].slot], code[ref].type);
+    }
+    if (iterated) {
+        for (auto [reg, ref] : snapshot.temporaries) {
+            context.regs[reg] = box(slots[code[ref].slot], code[ref].type);
+        }
+    }
+    earlyExits = iterated ? 0 : earlyExits + 1;
+    return snapshot.pc;
+}
+
+const GlobalAssumption* Trace::brokenAssumption(Module globals) const noexcept {
+    for (const auto& assumption : assumptions) {
+        if (!assumption.holds(globals)) return &assumption;
+    }
+    return nullptr;
+}
+
+std::string Trace::dump() const {
+    std::ostringstream out;
+    out << "trace @" << header << " (" << code.size() << " instructions, " << slotCount << " slots)\n";
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (i == loopStart) out << "  -- loop\n";
+        const IrInstr& instr = code[i];
+        out << "  %" << i << " = " << opName(instr.op) << ' ' << typeName(instr.type == IrType::NONE ? instr.operand : instr.type);
+        if (instr.op == IrOp::LOAD) out << " r" << instr.imm;
+        else if (instr.op == IrOp::GLOBAL) out << " g" << instr.imm;
+        else if (instr.op == IrOp::CONST) {
+            if (instr.type == IrType::FLOAT) out << ' ' << std::bit_cast<double>(instr.imm);
+            else out << ' ' << instr.imm;
+        }
+        for (IrRef ref : {instr.a, instr.b, instr.c}) {
+            if (ref != NO_REF) out << " %" << ref;
+        }
+        if (instr.snapshot) out << "  exit @" << snapshots[instr.snapshot].pc;
+        out << '\n';
+    }
+    return out.str();
+}
@@ -0,0 +1,395 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file trace_compiler.cpp
+ * @author lazypaws
+ * @brief Implementation of the MeowScript trace code generator
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/trace.h"
+#include "jit/assembler.h"
+
+using namespace meow::jit;
+using namespace meow::common;
+
+namespace {
+#ifdef MEOW_JIT_X86_64
+    // Operations not worth inlining call one of these, with their operands in memory. Non-zero means the guard failed
+    using TraceHelper = uint32_t (*)(JitContext*, const Trace*, uint32_t, Slot*);
+
+    // The helpers write whole words so booleans stay zero-extended, and leave the result alone when they fail
+    uint32_t loadRegister(JitContext* context, const Trace* trace, uint32_t index, Slot* slots) noexcept {
+        const IrInstr& instr = trace->code[index];
+        Slot value;
+        if (!unbox(context->regs[instr.imm], instr.type, value)) return 1;
+        slots[instr.slot] = value;
+        return 0;
+    }
+
+    uint32_t loadGlobal(JitContext* context, const Trace* trace, uint32_t index, Slot* slots) noexcept {
+        const IrInstr& instr = trace->code[index];
+        const GlobalCell& cell = context->globals->cell(static_cast<size_t>(instr.imm));
+        Slot value;
+        if (!cell.defined || !unbox(cell.value, instr.type, value)) return 1;
+        slots[instr.slot] = value;
+        return 0;
+    }
+
+    uint32_t arrayGet(JitContext*, const Trace* trace, uint32_t index, Slot* slots) noexcept {
+        const IrInstr& instr = trace->code[index];
+        ObjArray* array = slots[instr.operandSlots[0]].array;
+        uint64_t element = static_cast<uint64_t>(slots[instr.operandSlots[1]].i);
+        Slot value;
+        if (element >= array->size() || !unbox(array->get(element), instr.type, value)) return 1;
+        slots[instr.slot] = value;
+        return 0;
+    }
+
+    uint32_t arraySet(JitContext*, const Trace* trace, uint32_t index, Slot* slots) noexcept {
+        const IrInstr& instr = trace->code[index];
+        ObjArray* array = slots[instr.operandSlots[0]].array;
+        uint64_t element = static_cast<uint64_t>(slots[instr.operandSlots[1]].i);
+        if (element >= array->size()) return 1;
+        array->set(element, box(slots[instr.operandSlots[2]], trace->code[instr.c].type));
+        return 0;
+    }
+
+    // Callee-saved, so slots kept in them survive the helpers. r15 holds the slots, the context waits on the stack
+    constexpr Register ALLOCATABLE[] = {RBX, RBP, R12, R13, R14};
+    constexpr Register SLOTS = R15;
+    constexpr uint8_t IN_MEMORY = 0xFF;
+
+    inline bool hasResult(IrOp op) noexcept {
+        return op != IrOp::GUARD_TRUE && op != IrOp::GUARD_FALSE && op != IrOp::ARRAY_SET;
+    }
+
+    inline int32_t displacement(uint32_t slot) noexcept {
+        return static_cast<int32_t>(slot * sizeof(Slot));
+    }
+
+    // Works on the slots the optimizer assigned, so the code does what the IR executor does, slot for slot.
+    // Values are computed in rax and xmm0-1, then written to their slot's register or memory
+    class TraceCompiler {
+    public:
+        explicit TraceCompiler(const Trace& trace)
+            : trace(trace), scratch(static_cast<uint32_t>(trace.slotCount)), registers(trace.slotCount + 2, IN_MEMORY) {}
+
+        std::unique_ptr<CodeBlock> compile() {
+            allocate();
+
+            // Prologue: save the callee-saved registers, keeping the stack aligned for the helpers
+            for (Register reg : {RBX, RBP, R12, R13, R14, R15}) {
+                if (reg >= R8) assembler.byte(0x41);
+                assembler.byte(static_cast<uint8_t>(0x50 | (reg & 7)));                    // push reg
+            }
+            assembler.byte(0x48); assembler.byte(0x83); assembler.byte(0xEC); assembler.byte(0x08);    // sub rsp, 8
+            assembler.indirect(0, true, {0x89}, RDI, RSP, 0);                              // mov [rsp], rdi
+            assembler.direct(0, true, {0x89}, RSI, SLOTS);                                 // mov r15, rsi
+
+            const std::vector<IrInstr>& code = trace.code;
+            for (size_t i = 0; i < trace.loopStart; ++i) {
+                if (!emit(i)) return nullptr;
+            }
+            for (size_t phi = trace.loopStart; phi < trace.bodyStart; ++phi) {
+                move(code[phi].slot, code[phi].operandSlots[0]);
+            }
+            size_t loop = assembler.here();
+            for (size_t i = trace.bodyStart; i < code.size(); ++i) {
+                if (!emit(i)) return nullptr;
+            }
+            backEdge();
+            assembler.indirect(0, true, {0xC7}, 0, SLOTS, displacement(scratch + 1));      // mov qword [iterated], 1
+            assembler.imm32(1);
+            assembler.patch(assembler.branch({0xE9}), loop);                               // jmp loop
+
+            // Exits return the index of their instruction once the registers are back in their slots
+            std::vector<size_t> stubs(code.size(), 0);
+            std::vector<size_t> leaves;
+            for (auto [branch, index] : exits) {
+                if (!stubs[index]) {
+                    stubs[index] = assembler.here();
+                    assembler.byte(0xB8); assembler.imm32(static_cast<uint32_t>(index));     // mov eax, index
+                    leaves.push_back(assembler.branch({0xE9}));                            // jmp leave
+                }
+                assembler.patch(branch, stubs[index]);
+            }
+            for (size_t leave : leaves) assembler.patch(leave, assembler.here());
+            for (uint32_t slot = 0; slot < trace.slotCount; ++slot) {
+                if (registers[slot] != IN_MEMORY) assembler.indirect(0, true, {0x89}, registers[slot], SLOTS, displacement(slot));
+            }
+            assembler.byte(0x48); assembler.byte(0x83); assembler.byte(0xC4); assembler.byte(0x08);    // add rsp, 8
+            for (Register reg : {R15, R14, R13, R12, RBP, RBX}) {
+                if (reg >= R8) assembler.byte(0x41);
+                assembler.byte(static_cast<uint8_t>(0x58 | (reg & 7)));                    // pop reg
+            }
+            assembler.byte(0xC3);                                                          // ret
+
+            return std::make_unique<CodeBlock>(assembler.bytes);
+        }
+    private:
+        // Only uses inside the loop count, the slots used most get the registers
+        void allocate() {
+            const std::vector<IrInstr>& code = trace.code;
+            std::vector<uint32_t> uses(trace.slotCount, 0);
+            for (size_t i = trace.bodyStart; i < code.size(); ++i) {
+                const IrInstr& instr = code[i];
+                if (hasResult(instr.op)) ++uses[instr.slot];
+                IrRef operands[3] = {instr.a, instr.b, instr.c};
+                for (int k = 0; k < 3; ++k) {
+                    if (operands[k] != NO_REF) ++uses[instr.operandSlots[k]];
+                }
+            }
+            for (auto [phi, carried] : trace.backEdgeMoves) {
+                ++uses[phi];
+                ++uses[carried];
+            }
+
+            std::vector<uint32_t> slots(trace.slotCount);
+            for (uint32_t slot = 0; slot < trace.slotCount; ++slot) slots[slot] = slot;
+            std::stable_sort(slots.begin(), slots.end(), [&](uint32_t x, uint32_t y) { return uses[x] > uses[y]; });
+            for (size_t i = 0; i < slots.size() && i < std::size(ALLOCATABLE) && uses[slots[i]]; ++i) {
+                registers[slots[i]] = ALLOCATABLE[i];
+            }
+        }
+
+        // An instruction with 'reg' in its reg field and the slot as its register or memory operand
+        void operate(uint8_t prefix, std::initializer_list<uint8_t> opcode, uint8_t reg, uint32_t slot) {
+            if (registers[slot] != IN_MEMORY) assembler.direct(prefix, true, opcode, reg, registers[slot]);
+            else assembler.indirect(prefix, true, opcode, reg, SLOTS, displacement(slot));
+        }
+
+        void load(Register dst, uint32_t slot) {
+            if (registers[slot] != dst) operate(0, {0x8B}, dst, slot);                    // mov dst, slot
+        }
+
+        void store(uint32_t slot, Register src) {
+            if (registers[slot] != src) operate(0, {0x89}, src, slot);                    // mov slot, src
+        }
+
+        void loadFloat(uint8_t xmm, uint32_t slot) {
+            operate(0x66, {0x0F, 0x6E}, xmm, slot);                                        // movq xmm, slot
+        }
+
+        void storeFloat(uint32_t slot, uint8_t xmm) {
+            operate(0x66, {0x0F, 0x7E}, xmm, slot);                                        // movq slot, xmm
+        }
+
+        void move(uint32_t dst, uint32_t src) {
+            if (dst == src) return;
+            if (registers[dst] != IN_MEMORY) {
+                load(static_cast<Register>(registers[dst]), src);
+            } else if (registers[src] != IN_MEMORY) {
+                store(dst, static_cast<Register>(registers[src]));
+            } else {
+                load(RAX, src);
+                store(dst, RAX);
+            }
+        }
+
+        // The loop-carried values move into their phis all at once: a move waits until nothing reads its phi
+        // any more, and a cycle of moves is broken by parking one value in the scratch slot
+        void backEdge() {
+            std::vector<std::pair<uint32_t, uint32_t>> pending = trace.backEdgeMoves;
+            while (!pending.empty()) {
+                auto read = [&](uint32_t slot) {
+                    return std::any_of(pending.begin(), pending.end(), [&](const auto& other) { return other.second == slot; });
+                };
+                auto ready = std::find_if(pending.begin(), pending.end(), [&](const auto& pair) { return !read(pair.first); });
+                if (ready == pending.end()) {
+                    uint32_t parked = pending.front().second;
+                    move(scratch, parked);
+                    for (auto& pair : pending) {
+                        if (pair.second == parked) pair.second = scratch;
+                    }
+                    continue;
+                }
+                move(ready->first, ready->second);
+                pending.erase(ready);
+            }
+        }
+
+        void exit(std::initializer_list<uint8_t> branch, size_t index) {
+            exits.emplace_back(assembler.branch(branch), index);
+        }
+
+        // helper(context, trace, index, slots), with the operands written back to memory and the result read from it
+        void call(TraceHelper helper, size_t index) {
+            const IrInstr& instr = trace.code[index];
+            for (int k = 0; k < 3; ++k) {
+                IrRef operand = k == 0 ? instr.a : k == 1 ? instr.b : instr.c;
+                uint32_t slot = instr.operandSlots[k];
+                if (operand != NO_REF && registers[slot] != IN_MEMORY) {
+                    assembler.indirect(0, true, {0x89}, registers[slot], SLOTS, displacement(slot));
+                }
+            }
+            assembler.indirect(0, true, {0x8B}, RDI, RSP, 0);                              // mov rdi, [rsp]
+            assembler.load(RSI, reinterpret_cast<uint64_t>(&trace));                       // mov rsi, trace
+            assembler.byte(0xBA); assembler.imm32(static_cast<uint32_t>(index));             // mov edx, index
+            assembler.direct(0, true, {0x89}, SLOTS, RCX);                                 // mov rcx, r15
+            assembler.load(RAX, reinterpret_cast<uint64_t>(helper));                       // mov rax, helper
+            assembler.direct(0, false, {0xFF}, 2, RAX);                                    // call rax
+            assembler.direct(0, false, {0x85}, RAX, RAX);                                  // test eax, eax
+            exit({0x0F, 0x85}, index);                                                     // jnz exit
+            if (hasResult(instr.op) && registers[instr.slot] != IN_MEMORY) {
+                assembler.indirect(0, true, {0x8B}, registers[instr.slot], SLOTS, displacement(instr.slot));
+            }
+        }
+
+        // Sets ZF if 'a' is falsy, NaN included. Arrays are left to the executor
+        bool test(const IrInstr& instr) {
+            uint32_t slot = instr.operandSlots[0];
+            switch (trace.code[instr.a].type) {
+                case IrType::INT: case IrType::BOOL:
+                    if (registers[slot] != IN_MEMORY) {
+                        assembler.direct(0, true, {0x85}, registers[slot], registers[slot]);   // test reg, reg
+                    } else {
+                        assembler.indirect(0, true, {0x83}, 7, SLOTS, displacement(slot));     // cmp qword [slot], 0
+                        assembler.byte(0);
+                    }
+                    return true;
+                case IrType::FLOAT:
+                    loadFloat(0, slot);
+                    assembler.direct(0x66, false, {0x0F, 0x57}, 1, 1);                     // xorpd xmm1, xmm1
+                    assembler.direct(0x66, false, {0x0F, 0x2E}, 0, 1);                     // ucomisd xmm0, xmm1
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        void set(uint8_t condition, Register dst) {
+            assembler.direct(0, false, {0x0F, condition}, 0, dst);                         // setcc dst8
+        }
+
+        // Writes the boolean in al to the slot
+        void storeBool(uint32_t slot) {
+            assembler.direct(0, false, {0x0F, 0xB6}, RAX, RAX);                            // movzx eax, al
+            store(slot, RAX);
+        }
+
+        // Returns false if the trace uses an operation left to the executor
+        bool emit(size_t index) {
+            const IrInstr& instr = trace.code[index];
+            const uint32_t* operands = instr.operandSlots;
+            switch (instr.op) {
+                case IrOp::LOAD:
+                    call(loadRegister, index);
+                    return true;
+                case IrOp::GLOBAL:
+                    call(loadGlobal, index);
+                    return true;
+                case IrOp::CONST:
+                    if (registers[instr.slot] != IN_MEMORY) {
+                        assembler.load(static_cast<Register>(registers[instr.slot]), static_cast<uint64_t>(instr.imm));
+                    } else {
+                        assembler.load(RAX, static_cast<uint64_t>(instr.imm));
+                        store(instr.slot, RAX);
+                    }
+                    return true;
+                case IrOp::PHI:
+                    return true;
+                case IrOp::TO_FLOAT:
+                    operate(0xF2, {0x0F, 0x2A}, 0, operands[0]);                           // cvtsi2sd xmm0, a
+                    storeFloat(instr.slot, 0);
+                    return true;
+
+                case IrOp::ADD: case IrOp::SUB: case IrOp::MUL: case IrOp::DIV:
+                    if (instr.type == IrType::INT) {
+                        if (instr.op == IrOp::DIV) return false;
+                        load(RAX, operands[0]);
+                        if (instr.op == IrOp::ADD) operate(0, {0x03}, RAX, operands[1]);           // add rax, b
+                        else if (instr.op == IrOp::SUB) operate(0, {0x2B}, RAX, operands[1]);      // sub rax, b
+                        else operate(0, {0x0F, 0xAF}, RAX, operands[1]);                          // imul rax, b
+                        exit({0x0F, 0x80}, index);                                                 // jo exit
+                        store(instr.slot, RAX);
+                    } else {
+                        static constexpr uint8_t SSE[] = {0x58, 0x5C, 0x59, 0x5E};                 // addsd, subsd, mulsd, divsd
+                        loadFloat(0, operands[0]);
+                        loadFloat(1, operands[1]);
+                        assembler.direct(0xF2, false, {0x0F, SSE[static_cast<size_t>(instr.op) - static_cast<size_t>(IrOp::ADD)]}, 0, 1);
+                        storeFloat(instr.slot, 0);
+                    }
+                    return true;
+                case IrOp::NEG:
+                    load(RAX, operands[0]);
+                    if (instr.type == IrType::INT) {
+                        assembler.direct(0, true, {0xF7}, 3, RAX);                         // neg rax
+                        exit({0x0F, 0x80}, index);                                         // jo exit
+                    } else {
+                        assembler.direct(0, true, {0x0F, 0xBA}, 7, RAX);                   // btc rax, 63
+                        assembler.byte(63);
+                    }
+                    store(instr.slot, RAX);
+                    return true;
+
+                case IrOp::LT: case IrOp::LE: case IrOp::EQ: case IrOp::NE:
+                    if (instr.operand == IrType::FLOAT) {
+                        // Any comparison with NaN is false except NE: LT and LE are swapped into above and above-or-equal,
+                        // EQ and NE also look at the parity flag, which is set when the operands are unordered
+                        bool swapped = instr.op == IrOp::LT || instr.op == IrOp::LE;
+                        loadFloat(0, operands[swapped ? 1 : 0]);
+                        loadFloat(1, operands[swapped ? 0 : 1]);
+                        assembler.direct(0x66, false, {0x0F, 0x2E}, 0, 1);                 // ucomisd xmm0, xmm1
+                        if (instr.op == IrOp::LT) {
+                            set(0x97, RAX);                                                // seta al
+                        } else if (instr.op == IrOp::LE) {
+                            set(0x93, RAX);                                                // setae al
+                        } else if (instr.op == IrOp::EQ) {
+                            set(0x94, RAX);                                                // sete al
+                            set(0x9B, RCX);                                                // setnp cl
+                            assembler.direct(0, false, {0x20}, RCX, RAX);                  // and al, cl
+                        } else {
+                            set(0x95, RAX);                                                // setne al
+                            set(0x9A, RCX);                                                // setp cl
+                            assembler.direct(0, false, {0x08}, RCX, RAX);                  // or al, cl
+                        }
+                    } else {
+                        static constexpr uint8_t CONDITIONS[] = {0x9C, 0x9E, 0x94, 0x95};  // setl, setle, sete, setne
+                        load(RAX, operands[0]);
+                        operate(0, {0x3B}, RAX, operands[1]);                              // cmp rax, b
+                        set(CONDITIONS[static_cast<size_t>(instr.op) - static_cast<size_t>(IrOp::LT)], RAX);
+                    }
+                    storeBool(instr.slot);
+                    return true;
+                case IrOp::NOT:
+                    if (!test(instr)) return false;
+                    set(0x94, RAX);                                                        // sete al
+                    storeBool(instr.slot);
+                    return true;
+
+                case IrOp::GUARD_TRUE:
+                    if (!test(instr)) return false;
+                    exit({0x0F, 0x84}, index);                                             // jz exit
+                    return true;
+                case IrOp::GUARD_FALSE:
+                    if (!test(instr)) return false;
+                    exit({0x0F, 0x85}, index);                                             // jnz exit
+                    return true;
+
+                case IrOp::ARRAY_GET:
+                    call(arrayGet, index);
+                    return true;
+                case IrOp::ARRAY_SET:
+                    call(arraySet, index);
+                    return true;
+            }
+            return false;
+        }
+
+        const Trace& trace;
+        Assembler assembler;
+        uint32_t scratch;                   // Breaks cycles of back-edge moves, the slot after it is set once the loop went around
+        std::vector<uint8_t> registers;     // The register of every slot, IN_MEMORY for the others
+        std::vector<std::pair<size_t, size_t>> exits;  // (displacement, index of the instruction)
+    };
+#endif
+}
+
+std::unique_ptr<CodeBlock> meow::jit::compileTrace(const Trace& trace) {
+#ifdef MEOW_JIT_X86_64
+    return TraceCompiler(trace).compile();
+#else
+    (void)trace;
+    return nullptr;
+#endif
+}
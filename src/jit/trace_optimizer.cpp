@@ -0,0 +1,293 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file trace_optimizer.cpp
+ * @author lazypaws
+ * @brief Implementation of the MeowScript trace optimizer
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/trace.h"
+
+#include <map>
+#include <tuple>
+
+using namespace meow::jit;
+
+namespace {
+    inline bool isGuard(IrOp op) noexcept {
+        switch (op) {
+            case IrOp::LOAD: case IrOp::GLOBAL: case IrOp::GUARD_TRUE: case IrOp::GUARD_FALSE:
+            case IrOp::ARRAY_GET: case IrOp::ARRAY_SET:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Integer arithmetic guards overflow, the float forms can't fail
+    inline bool canExit(const IrInstr& instr) noexcept {
+        if (isGuard(instr.op)) return true;
+        return instr.type == IrType::INT && (instr.op == IrOp::ADD || instr.op == IrOp::SUB || instr.op == IrOp::MUL || instr.op == IrOp::NEG);
+    }
+
+    inline bool hasResult(IrOp op) noexcept {
+        return op != IrOp::GUARD_TRUE && op != IrOp::GUARD_FALSE && op != IrOp::ARRAY_SET;
+    }
+
+    template <typename Function>
+    void forOperands(IrInstr& instr, Function&& function) {
+        if (instr.a != NO_REF) function(instr.a);
+        if (instr.b != NO_REF) function(instr.b);
+        if (instr.c != NO_REF) function(instr.c);
+    }
+
+    inline double asFloat(const IrInstr& instr) noexcept {
+        return std::bit_cast<double>(instr.imm);
+    }
+
+    bool truth(const IrInstr& constant) noexcept {
+        switch (constant.type) {
+            case IrType::INT: return constant.imm != 0;
+            case IrType::FLOAT: return asFloat(constant) != 0.0 && !std::isnan(asFloat(constant));
+            default: return constant.imm != 0;
+        }
+    }
+
+    // Evaluates an instruction whose operands are all constants, returns 'false' if it can't be folded
+    bool fold(IrInstr& instr, const std::vector<IrInstr>& code) {
+        auto isConstant = [&](IrRef ref) { return ref == NO_REF || code[ref].op == IrOp::CONST; };
+        if (instr.op == IrOp::CONST || instr.op == IrOp::PHI || instr.op == IrOp::LOAD || instr.op == IrOp::GLOBAL) return false;
+        if (!isConstant(instr.a) || !isConstant(instr.b) || !isConstant(instr.c)) return false;
+        if (instr.op == IrOp::ARRAY_GET || instr.op == IrOp::ARRAY_SET) return false;
+
+        const IrInstr& a = code[instr.a];
+        const IrInstr* b = instr.b != NO_REF ? &code[instr.b] : nullptr;
+        int64_t result = 0;
+        switch (instr.op) {
+            case IrOp::TO_FLOAT: result = std::bit_cast<int64_t>(static_cast<double>(a.imm)); break;
+            case IrOp::ADD: case IrOp::SUB: case IrOp::MUL: case IrOp::DIV: {
+                if (instr.type == IrType::INT) {
+                    bool overflow = instr.op == IrOp::ADD ? __builtin_add_overflow(a.imm, b->imm, &result)
+                                  : instr.op == IrOp::SUB ? __builtin_sub_overflow(a.imm, b->imm, &result)
+                                  : __builtin_mul_overflow(a.imm, b->imm, &result);
+                    if (overflow) return false;     // Leave it to the guard
+                } else {
+                    double x = asFloat(a), y = asFloat(*b);
+                    double value = instr.op == IrOp::ADD ? x + y : instr.op == IrOp::SUB ? x - y : instr.op == IrOp::MUL ? x * y : x / y;
+                    result = std::bit_cast<int64_t>(value);
+                }
+                break;
+            }
+            case IrOp::NEG:
+                if (instr.type == IrType::INT) {
+                    if (__builtin_sub_overflow(int64_t{0}, a.imm, &result)) return false;
+                } else {
+                    result = std::bit_cast<int64_t>(-asFloat(a));
+                }
+                break;
+            case IrOp::LT: case IrOp::LE: case IrOp::EQ: case IrOp::NE: {
+                bool value;
+                if (instr.operand == IrType::FLOAT) {
+                    double x = asFloat(a), y = asFloat(*b);
+                    value = instr.op == IrOp::LT ? x < y : instr.op == IrOp::LE ? x <= y : instr.op == IrOp::EQ ? x == y : x != y;
+                } else {
+                    int64_t x = a.imm, y = b->imm;
+                    value = instr.op == IrOp::LT ? x < y : instr.op == IrOp::LE ? x <= y : instr.op == IrOp::EQ ? x == y : x != y;
+                }
+                result = value;
+                break;
+            }
+            case IrOp::NOT: result = !truth(a); break;
+            default: return false;
+        }
+        IrType type = instr.type;
+        instr = IrInstr{IrOp::CONST, type};
+        instr.imm = result;
+        return true;
+    }
+}
+
+bool meow::jit::optimizeTrace(Trace& trace) {
+    std::vector<IrInstr>& code = trace.code;
+    size_t count = code.size();
+    bool stores = std::any_of(code.begin(), code.end(), [](const IrInstr& instr) { return instr.op == IrOp::ARRAY_SET; });
+
+    // Constant folding, redundant guard and common subexpression elimination, in recording order
+    std::vector<IrRef> replaced(count);
+    std::vector<bool> removed(count, false);
+    for (size_t i = 0; i < count; ++i) replaced[i] = static_cast<IrRef>(i);
+    auto resolve = [&](IrRef& ref) {
+        while (replaced[ref] != ref) ref = replaced[ref];
+    };
+    using Key = std::tuple<IrOp, IrType, IrType, IrRef, IrRef, IrRef, int64_t>;
+    std::map<Key, IrRef> seen;
+
+    for (size_t i = 0; i < count; ++i) {
+        IrInstr& instr = code[i];
+        forOperands(instr, resolve);
+        if (instr.op == IrOp::PHI || instr.op == IrOp::ARRAY_SET) continue;
+        fold(instr, code);
+        // A guard on a constant either always passes or makes the whole trace useless
+        if (instr.op == IrOp::GUARD_TRUE || instr.op == IrOp::GUARD_FALSE) {
+            if (code[instr.a].op == IrOp::CONST) {
+                if (truth(code[instr.a]) != (instr.op == IrOp::GUARD_TRUE)) return false;
+                removed[i] = true;
+                continue;
+            }
+        }
+        // Array elements can change under stores, so loads from them are only shared in store-free traces
+        if (instr.op == IrOp::ARRAY_GET && stores) continue;
+        Key key{instr.op, instr.type, instr.operand, instr.a, instr.b, instr.c, instr.imm};
+        auto [found, inserted] = seen.emplace(key, static_cast<IrRef>(i));
+        if (!inserted) {
+            replaced[i] = found->second;
+            removed[i] = true;
+        }
+    }
+    for (auto& instr : code) {
+        if (instr.op == IrOp::PHI) forOperands(instr, resolve);
+    }
+    for (auto& snapshot : trace.snapshots) {
+        for (auto& entry : snapshot.registers) resolve(entry.second);
+        for (auto& entry : snapshot.temporaries) resolve(entry.second);
+    }
+
+    // Loop-invariant code motion: anything computed only from invariants moves to the preamble
+    std::vector<bool> invariant(count, false);
+    for (size_t i = 0; i < count; ++i) {
+        IrInstr& instr = code[i];
+        if (removed[i] || instr.op == IrOp::PHI || instr.op == IrOp::ARRAY_SET) continue;
+        if (instr.op == IrOp::ARRAY_GET && stores) continue;
+        bool operandsInvariant = true;
+        forOperands(instr, [&](IrRef& ref) { operandsInvariant = operandsInvariant && invariant[ref]; });
+        invariant[i] = operandsInvariant;
+    }
+
+    // Dead code elimination: guards, stores, phis and whatever the exits need are live
+    std::vector<bool> live(count, false);
+    std::vector<IrRef> worklist;
+    auto markLive = [&](IrRef ref) {
+        if (!live[ref]) {
+            live[ref] = true;
+            worklist.push_back(ref);
+        }
+    };
+    for (size_t i = 0; i < count; ++i) {
+        if (removed[i]) continue;
+        if (canExit(code[i]) || code[i].op == IrOp::PHI) {
+            markLive(static_cast<IrRef>(i));
+            if (!invariant[i]) {
+                for (auto& entry : trace.snapshots[code[i].snapshot].registers) markLive(entry.second);
+                for (auto& entry : trace.snapshots[code[i].snapshot].temporaries) markLive(entry.second);
+            }
+        }
+    }
+    while (!worklist.empty()) {
+        IrRef ref = worklist.back();
+        worklist.pop_back();
+        forOperands(code[ref], markLive);
+    }
+    // A load nothing reads only guards a type nobody relies on
+    for (size_t i = 0; i < count; ++i) {
+        if (code[i].op == IrOp::LOAD && live[i]) {
+            bool used = false;
+            for (size_t j = 0; j < count && !used; ++j) {
+                if (!live[j] || j == i) continue;
+                IrInstr& other = code[j];
+                used = other.a == i || other.b == i || other.c == i;
+                if (!used && canExit(other) && !invariant[j]) {
+                    const Snapshot& snapshot = trace.snapshots[other.snapshot];
+                    for (auto& entry : snapshot.registers) used = used || entry.second == i;
+                    for (auto& entry : snapshot.temporaries) used = used || entry.second == i;
+                }
+            }
+            live[i] = used;
+        }
+    }
+
+    // Lay out the preamble, the phis and the body
+    std::vector<IrRef> order;
+    for (size_t i = 0; i < count; ++i) if (live[i] && invariant[i]) order.push_back(static_cast<IrRef>(i));
+    size_t loopStart = order.size();
+    for (size_t i = 0; i < count; ++i) if (live[i] && code[i].op == IrOp::PHI) order.push_back(static_cast<IrRef>(i));
+    size_t bodyStart = order.size();
+    for (size_t i = 0; i < count; ++i) if (live[i] && !invariant[i] && code[i].op != IrOp::PHI) order.push_back(static_cast<IrRef>(i));
+
+    std::vector<IrRef> position(count, NO_REF);
+    for (size_t i = 0; i < order.size(); ++i) position[order[i]] = static_cast<IrRef>(i);
+    auto relocate = [&](IrRef& ref) { ref = position[ref]; };
+
+    std::vector<IrInstr> laidOut;
+    laidOut.reserve(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        IrInstr instr = code[order[i]];
+        forOperands(instr, relocate);
+        // Guards hoisted out of the loop fail before anything was written, the interpreter just restarts the loop
+        if (i < loopStart) instr.snapshot = 0;
+        laidOut.push_back(instr);
+    }
+    for (auto& snapshot : trace.snapshots) {
+        for (auto& entry : snapshot.registers) relocate(entry.second);
+        for (auto& entry : snapshot.temporaries) relocate(entry.second);
+    }
+    code = std::move(laidOut);
+    trace.loopStart = loopStart;
+    trace.bodyStart = bodyStart;
+
+    // Slot allocation: body values give their slot back after their last use, the rest keep theirs for the whole loop
+    size_t size = code.size();
+    std::vector<size_t> lastUse(size, 0);
+    auto use = [&](IrRef ref, size_t at) { lastUse[ref] = std::max(lastUse[ref], at); };
+    for (size_t i = 0; i < size; ++i) {
+        IrInstr& instr = code[i];
+        if (instr.op == IrOp::PHI) {
+            use(instr.b, size);     // Read when the back-edge is taken
+            continue;
+        }
+        forOperands(instr, [&](IrRef& ref) { use(ref, i); });
+        if (canExit(instr) && i >= bodyStart) {
+            for (auto& entry : trace.snapshots[instr.snapshot].registers) use(entry.second, i);
+            // Temporaries are read from the previous iteration, their slots must survive the back-edge
+            for (auto& entry : trace.snapshots[instr.snapshot].temporaries) use(entry.second, size);
+        }
+    }
+
+    // A value carried to the next iteration is computed straight into its phi's slot when the phi is dead by then
+    std::unordered_map<IrRef, IrRef> carriedBy;
+    for (size_t i = loopStart; i < bodyStart; ++i) {
+        if (code[i].b >= bodyStart) carriedBy.emplace(code[i].b, static_cast<IrRef>(i));
+    }
+
+    std::vector<uint32_t> freeSlots;
+    std::vector<std::vector<IrRef>> expiring(size + 1);
+    uint32_t slots = 0;
+    for (size_t i = 0; i < size; ++i) {
+        IrInstr& instr = code[i];
+        auto carried = carriedBy.find(static_cast<IrRef>(i));
+        if (carried != carriedBy.end() && lastUse[carried->second] <= i) {
+            instr.slot = code[carried->second].slot;
+        } else if (hasResult(instr.op)) {
+            if (i >= bodyStart && !freeSlots.empty()) {
+                instr.slot = freeSlots.back();
+                freeSlots.pop_back();
+            } else {
+                instr.slot = slots++;
+            }
+            if (i >= bodyStart) expiring[std::max(lastUse[i], i)].push_back(static_cast<IrRef>(i));
+        }
+        for (IrRef ref : expiring[i]) freeSlots.push_back(code[ref].slot);
+    }
+    trace.slotCount = slots;
+
+    for (auto& instr : code) {
+        IrRef operands[3] = {instr.a, instr.b, instr.c};
+        for (int i = 0; i < 3; ++i) {
+            if (operands[i] != NO_REF) instr.operandSlots[i] = code[operands[i]].slot;
+        }
+    }
+    trace.backEdgeMoves.clear();
+    for (size_t i = loopStart; i < bodyStart; ++i) {
+        if (code[i].slot != code[i].operandSlots[1]) trace.backEdgeMoves.emplace_back(code[i].slot, code[i].operandSlots[1]);
+    }
+    return true;
+}
@@ -0,0 +1,371 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file trace_recorder.cpp
+ * @author lazypaws
+ * @brief Implementation of the MeowScript trace recorder
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "jit/trace.h"
+#include "jit/jit_helpers.h"
+#include "runtime/chunk.h"
+
+using namespace meow::jit;
+using namespace meow::common;
+
+namespace {
+    // Longer paths are unlikely to be loops worth tracing
+    constexpr size_t MAX_TRACE_INSTRUCTIONS = 512;
+
+    IrType typeOf(const Value& value) noexcept {
+        if (value.is<Int>()) return IrType::INT;
+        if (value.is<Float>()) return IrType::FLOAT;
+        if (value.is<Bool>()) return IrType::BOOL;
+        if (value.is<Array>()) return IrType::ARRAY;
+        return IrType::NONE;
+    }
+
+    inline bool isNumeric(IrType type) noexcept {
+        return type == IrType::INT || type == IrType::FLOAT;
+    }
+
+    // Thrown to stop recording, the instruction being recorded hasn't run yet
+    struct Abort {};
+
+    class Recorder {
+    public:
+        Recorder(JitContext& context, const ObjProto& proto, Trace& trace) : context(context), proto(proto), trace(trace) {
+            trace.snapshots.push_back(Snapshot{trace.header, {}, {}});
+        }
+
+        IrRef emit(IrInstr instr) {
+            trace.code.push_back(instr);
+            return static_cast<IrRef>(trace.code.size() - 1);
+        }
+
+        IrRef constant(IrType type, int64_t bits) {
+            IrInstr instr{IrOp::CONST, type};
+            instr.imm = bits;
+            return emit(instr);
+        }
+
+        // Guards leave the trace at the instruction that emitted them, with what this iteration wrote so far
+        uint32_t snapshot(size_t pc) {
+            Snapshot snapshot{static_cast<uint32_t>(pc), {}, {}};
+            for (uint16_t reg : written) {
+                snapshot.registers.emplace_back(reg, current[reg]);
+            }
+            trace.snapshots.push_back(std::move(snapshot));
+            return static_cast<uint32_t>(trace.snapshots.size() - 1);
+        }
+
+        IrRef exit(IrInstr instr, size_t pc) {
+            instr.snapshot = snapshot(pc);
+            return emit(instr);
+        }
+
+        // Sites whose guards kept failing aren't guarded again, the loop is left to the interpreter instead
+        IrRef guard(IrInstr instr, size_t pc) {
+            if (!maySpeculate(proto, static_cast<uint32_t>(pc))) throw Abort{};
+            return exit(instr, pc);
+        }
+
+        // Registers read before this iteration writes them are loaded once, guarded to the type they have now
+        IrRef read(uint16_t reg) {
+            if (auto found = current.find(reg); found != current.end()) return found->second;
+            IrType type = typeOf(context.regs[reg]);
+            if (type == IrType::NONE) throw Abort{};
+            IrInstr instr{IrOp::LOAD, type};
+            instr.imm = reg;
+            IrRef ref = emit(instr);
+            current[reg] = ref;
+            entries[reg] = ref;
+            return ref;
+        }
+
+        void write(uint16_t reg, IrRef ref) {
+            if (std::find(written.begin(), written.end(), reg) == written.end()) written.push_back(reg);
+            current[reg] = ref;
+        }
+
+        IrType type(IrRef ref) const {
+            return trace.code[ref].type;
+        }
+
+        IrRef toFloat(IrRef ref) {
+            if (type(ref) == IrType::FLOAT) return ref;
+            return emit(IrInstr{IrOp::TO_FLOAT, IrType::FLOAT, IrType::NONE, ref});
+        }
+
+        // Int with Int stays integral with an overflow guard, any other mix of numbers is done in floating point
+        void arithmetic(IrOp op, uint16_t dst, uint16_t a, uint16_t b, size_t pc) {
+            IrRef lhs = read(a), rhs = read(b);
+            if (!isNumeric(type(lhs)) || !isNumeric(type(rhs))) throw Abort{};
+            if (op != IrOp::DIV && type(lhs) == IrType::INT && type(rhs) == IrType::INT) {
+                write(dst, guard(IrInstr{op, IrType::INT, IrType::NONE, lhs, rhs}, pc));
+            } else {
+                write(dst, emit(IrInstr{op, IrType::FLOAT, IrType::NONE, toFloat(lhs), toFloat(rhs)}));
+            }
+        }
+
+        void comparison(IrOp op, uint16_t dst, uint16_t a, uint16_t b) {
+            IrRef lhs = read(a), rhs = read(b);
+            IrType operand;
+            if (type(lhs) == IrType::INT && type(rhs) == IrType::INT) {
+                operand = IrType::INT;
+            } else if (isNumeric(type(lhs)) && isNumeric(type(rhs))) {
+                operand = IrType::FLOAT;
+                lhs = toFloat(lhs);
+                rhs = toFloat(rhs);
+            } else if ((op == IrOp::EQ || op == IrOp::NE) && type(lhs) == IrType::BOOL && type(rhs) == IrType::BOOL) {
+                operand = IrType::BOOL;
+            } else {
+                throw Abort{};
+            }
+            write(dst, emit(IrInstr{op, IrType::BOOL, operand, lhs, rhs}));
+        }
+
+        // Records the instruction at pc before it runs, returns 'false' if the recorder moves the pc itself
+        bool record(const uint8_t* code, size_t pc, size_t& next) {
+            OpCode op = static_cast<OpCode>(code[pc]);
+            uint32_t operands[3];
+            decodeOperands(code, pc, operands);
+            uint16_t x = static_cast<uint16_t>(operands[0]), y = static_cast<uint16_t>(operands[1]), z = static_cast<uint16_t>(operands[2]);
+
+            switch (op) {
+                case OpCode::LOAD_CONST: {
+                    const Value& value = context.constants[y];
+                    if (const Int* i = value.get_if<Int>()) write(x, constant(IrType::INT, *i));
+                    else if (const Float* f = value.get_if<Float>()) write(x, constant(IrType::FLOAT, std::bit_cast<int64_t>(*f)));
+                    else if (const Bool* b = value.get_if<Bool>()) write(x, constant(IrType::BOOL, *b));
+                    else throw Abort{};
+                    return true;
+                }
+                case OpCode::LOAD_INT:
+                    write(x, constant(IrType::INT, static_cast<int64_t>((static_cast<uint64_t>(operands[2]) << 32) | operands[1])));
+                    return true;
+                case OpCode::LOAD_TRUE: write(x, constant(IrType::BOOL, 1)); return true;
+                case OpCode::LOAD_FALSE: write(x, constant(IrType::BOOL, 0)); return true;
+                case OpCode::MOVE: write(x, read(y)); return true;
+
+                case OpCode::GET_GLOBAL: {
+                    const GlobalCell& cell = context.globals->cell(y);
+                    IrType type = cell.defined ? typeOf(cell.value) : IrType::NONE;
+                    if (type == IrType::NONE) throw Abort{};
+
+                    // Globals are mostly assigned once, so the value is assumed to stay until that failed here before
+                    if (maySpeculate(proto, static_cast<uint32_t>(pc))) {
+                        int64_t bits = 0;
+                        if (type == IrType::INT) bits = cell.value.get<Int>();
+                        else if (type == IrType::FLOAT) bits = std::bit_cast<int64_t>(cell.value.get<Float>());
+                        else if (type == IrType::BOOL) bits = cell.value.get<Bool>();
+                        else bits = reinterpret_cast<int64_t>(cell.value.get<Array>());
+                        trace.assumptions.push_back(GlobalAssumption{static_cast<uint32_t>(pc), y, cell.assignments});
+                        write(x, constant(type, bits));
+                        return true;
+                    }
+                    IrInstr instr{IrOp::GLOBAL, type};
+                    instr.imm = y;
+                    write(x, exit(instr, pc));     // What the site falls back to, so it's not subject to its deopts
+                    return true;
+                }
+
+                case OpCode::ADD: case OpCode::ADD_INT_INT: case OpCode::ADD_FLOAT_FLOAT:
+                    arithmetic(IrOp::ADD, x, y, z, pc); return true;
+                case OpCode::SUB: case OpCode::SUB_INT_INT: case OpCode::SUB_FLOAT_FLOAT:
+                    arithmetic(IrOp::SUB, x, y, z, pc); return true;
+                case OpCode::MUL: case OpCode::MUL_INT_INT: case OpCode::MUL_FLOAT_FLOAT:
+                    arithmetic(IrOp::MUL, x, y, z, pc); return true;
+                case OpCode::DIV:
+                    arithmetic(IrOp::DIV, x, y, z, pc); return true;
+                case OpCode::NEG: {
+                    IrRef value = read(y);
+                    if (type(value) == IrType::INT) write(x, guard(IrInstr{IrOp::NEG, IrType::INT, IrType::NONE, value}, pc));
+                    else if (type(value) == IrType::FLOAT) write(x, emit(IrInstr{IrOp::NEG, IrType::FLOAT, IrType::NONE, value}));
+                    else throw Abort{};
+                    return true;
+                }
+                case OpCode::NOT:
+                    write(x, emit(IrInstr{IrOp::NOT, IrType::BOOL, IrType::NONE, read(y)}));
+                    return true;
+
+                case OpCode::LT: case OpCode::LT_INT_INT: case OpCode::LT_FLOAT_FLOAT:
+                    comparison(IrOp::LT, x, y, z); return true;
+                case OpCode::LE: comparison(IrOp::LE, x, y, z); return true;
+                case OpCode::GT: comparison(IrOp::LT, x, z, y); return true;
+                case OpCode::GE: comparison(IrOp::LE, x, z, y); return true;
+                case OpCode::EQ: case OpCode::EQ_INT_INT:
+                    comparison(IrOp::EQ, x, y, z); return true;
+                case OpCode::NEQ: comparison(IrOp::NE, x, y, z); return true;
+
+                case OpCode::GET_INDEX: case OpCode::GET_INDEX_ARRAY_INT: {
+                    IrRef array = read(y), index = read(z);
+                    if (type(array) != IrType::ARRAY || type(index) != IrType::INT) throw Abort{};
+                    Array object = context.regs[y].get<Array>();
+                    Int i = context.regs[z].get<Int>();
+                    if (i < 0 || static_cast<uint64_t>(i) >= object->size()) throw Abort{};
+                    IrType element = typeOf(object->get(static_cast<size_t>(i)));
+                    if (element == IrType::NONE) throw Abort{};
+                    write(x, guard(IrInstr{IrOp::ARRAY_GET, element, IrType::NONE, array, index}, pc));
+                    return true;
+                }
+                case OpCode::SET_INDEX: {
+                    IrRef array = read(x), index = read(y), value = read(z);
+                    if (type(array) != IrType::ARRAY || type(index) != IrType::INT) throw Abort{};
+                    guard(IrInstr{IrOp::ARRAY_SET, IrType::NONE, IrType::NONE, array, index, value}, pc);
+                    return true;
+                }
+
+                case OpCode::SETUP_TRY:
+                case OpCode::POP_TRY:
+                    return true;
+
+                case OpCode::JUMP:
+                    next = operands[0];
+                    if (next < pc && next != trace.header) throw Abort{};     // An inner loop gets its own trace
+                    return false;
+                case OpCode::JUMP_IF_FALSE:
+                case OpCode::JUMP_IF_TRUE: {
+                    IrRef cond = read(x);
+                    bool truth = context.regs[x].asBool();
+                    guard(IrInstr{truth ? IrOp::GUARD_TRUE : IrOp::GUARD_FALSE, IrType::NONE, IrType::NONE, cond}, pc);
+                    bool taken = truth == (op == OpCode::JUMP_IF_TRUE);
+                    next = taken ? operands[1] : pc + instructionSize(op);
+                    if (next < pc && next != trace.header) throw Abort{};
+                    return false;
+                }
+                // The iterations left count down to zero, the index can't overflow before they run out.
+                // Traces are entered right after FORLOOP, so until the body assigns the loop variable it is the index,
+                // reading it instead keeps the index out of the loop-carried registers
+                case OpCode::FORLOOP: {
+                    bool assigned = std::find(written.begin(), written.end(), x + 3) != written.end();
+                    IrRef index = read(assigned ? x : x + 3), left = read(x + 1), step = read(x + 2);
+                    if (type(index) != IrType::INT || type(left) != IrType::INT || type(step) != IrType::INT) throw Abort{};
+                    IrRef more = emit(IrInstr{IrOp::NE, IrType::BOOL, IrType::INT, left, constant(IrType::INT, 0)});
+                    bool taken = forLoop(&context, static_cast<uint32_t>(pc), x, 0, 0);
+                    guard(IrInstr{taken ? IrOp::GUARD_TRUE : IrOp::GUARD_FALSE, IrType::NONE, IrType::NONE, more}, pc);
+                    if (taken) {
+                        IrRef remaining = guard(IrInstr{IrOp::SUB, IrType::INT, IrType::NONE, left, constant(IrType::INT, 1)}, pc);
+                        IrRef stepped = guard(IrInstr{IrOp::ADD, IrType::INT, IrType::NONE, index, step}, pc);
+                        write(x, stepped);
+                        write(x + 1, remaining);
+                        write(x + 3, stepped);
+                    }
+                    next = taken ? operands[1] : pc + instructionSize(op);
+                    if (next < pc && next != trace.header) throw Abort{};
+                    return false;
+                }
+
+                default:
+                    throw Abort{};
+            }
+        }
+
+        // Loop-carried registers become phis, the other registers the body writes are only written back on exit
+        bool finish() {
+            std::unordered_map<IrRef, IrRef> phis;
+            std::vector<std::pair<uint16_t, IrRef>> carried, temporaries;
+            for (uint16_t reg : written) {
+                IrRef last = current[reg];
+                auto entry = entries.find(reg);
+                if (entry == entries.end()) {
+                    temporaries.emplace_back(reg, last);
+                    continue;
+                }
+                if (type(entry->second) != type(last)) return false;   // The loop changes the type of a register
+                IrRef phi = emit(IrInstr{IrOp::PHI, type(last), IrType::NONE, entry->second, last});
+                phis[entry->second] = phi;
+                carried.emplace_back(reg, phi);
+            }
+
+            // Inside the body, the value a register had on entry is the one the previous iteration left
+            auto carry = [&](IrRef& ref) {
+                if (auto found = phis.find(ref); found != phis.end()) ref = found->second;
+            };
+            for (auto& instr : trace.code) {
+                if (instr.op == IrOp::PHI) {
+                    carry(instr.b);
+                    continue;
+                }
+                if (instr.a != NO_REF) carry(instr.a);
+                if (instr.b != NO_REF) carry(instr.b);
+                if (instr.c != NO_REF) carry(instr.c);
+            }
+            // A temporary left holding the value another register had on entry would need that phi from the previous
+            // iteration, which the back-edge already overwrote
+            for (auto& temporary : temporaries) {
+                if (phis.count(temporary.second)) return false;
+            }
+            for (size_t i = 1; i < trace.snapshots.size(); ++i) {
+                Snapshot& snapshot = trace.snapshots[i];
+                auto present = [&](uint16_t reg) {
+                    return std::any_of(snapshot.registers.begin(), snapshot.registers.end(), [&](const auto& entry) { return entry.first == reg; });
+                };
+                for (auto& entry : snapshot.registers) carry(entry.second);
+                // Registers this iteration hasn't written yet still hold what the previous iteration left
+                for (auto [reg, phi] : carried) {
+                    if (!present(reg)) snapshot.registers.emplace_back(reg, phi);
+                }
+                for (auto [reg, last] : temporaries) {
+                    if (!present(reg)) snapshot.temporaries.emplace_back(reg, last);
+                }
+            }
+            return true;
+        }
+    private:
+        JitContext& context;
+        const ObjProto& proto;
+        Trace& trace;
+        std::unordered_map<uint16_t, IrRef> current;
+        std::unordered_map<uint16_t, IrRef> entries;
+        std::vector<uint16_t> written;
+    };
+}
+
+std::unique_ptr<Trace> meow::jit::recordTrace(JitContext& context, const ObjProto& proto, uint32_t header, size_t& resumePc) {
+    const uint8_t* code = proto.chunk->data();
+    // Traces of this loop kept leaving before their first iteration
+    if (!maySpeculate(proto, header)) return nullptr;
+
+    auto trace = std::make_unique<Trace>();
+    trace->header = header;
+    Recorder recorder(context, proto, *trace);
+
+    size_t pc = header;
+    for (size_t count = 0;; ++count) {
+        resumePc = pc;
+        if (count == MAX_TRACE_INSTRUCTIONS) return nullptr;
+
+        size_t next = pc + instructionSize(static_cast<OpCode>(code[pc]));
+        bool runs;
+        try {
+            runs = recorder.record(code, pc, next);
+        } catch (const Abort&) {
+            return nullptr;
+        } catch (...) {
+            return nullptr;     // Out of memory while recording, the interpreter runs the instruction instead
+        }
+
+        // The recorded instruction runs through the same helper compiled code uses
+        if (runs) {
+            OpCode op = static_cast<OpCode>(code[pc]);
+            if (Helper helper = helperFor(op)) {
+                uint32_t operands[3];
+                decodeOperands(code, pc, operands);
+                if (helper(&context, static_cast<uint32_t>(pc), operands[0], operands[1], operands[2])) return nullptr;
+            }
+        }
+
+        pc = next;
+        if (pc == header) break;
+    }
+
+    resumePc = header;
+    if (!recorder.finish() || !optimizeTrace(*trace)) return nullptr;
+    try {
+        trace->machineCode = compileTrace(*trace);
+    } catch (...) {
+        // Out of executable memory, the IR executor runs the trace instead
+    }
+    return trace;
+}
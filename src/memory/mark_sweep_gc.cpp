@@ -0,0 +1,51 @@
+#include "memory/mark_sweep_gc.h"
+#include "common/definitions.h"
+#include "runtime/meow_state.h"
+
+using namespace meow::memory;
+
+MarkSweepGC::~MarkSweepGC() {
+    for (auto object : objects) {
+        delete object;
+    }
+}
+
+void MarkSweepGC::registerObject(MeowObject* object) {
+    objects.push_back(object);
+}
+
+size_t MarkSweepGC::collect(meow::runtime::MeowState& state) {
+    state.clearDeadSlots();
+    for (auto root : state.getRoots()) {
+        visitObject(root);
+    }
+
+    while (!grayStack.empty()) {
+        MeowObject* object = grayStack.back();
+        grayStack.pop_back();
+        object->trace(*this);
+    }
+
+    // Sweeps unmarked objects and compacts the survivors in place
+    size_t alive = 0;
+    for (auto object : objects) {
+        if (object->marked) {
+            object->marked = false;
+            objects[alive++] = object;
+        } else {
+            delete object;
+        }
+    }
+    objects.resize(alive);
+    return alive;
+}
+
+void MarkSweepGC::visitValue(meow::common::Value& value) {
+    visitObject(meow::common::heapObject(value));
+}
+
+void MarkSweepGC::visitObject(MeowObject* object) {
+    if (!object || object->marked) return;
+    object->marked = true;
+    grayStack.push_back(object);
+}
@@ -0,0 +1,6 @@
+#include "memory/memory_manager.h"
+
+using namespace meow::memory;
+
+MemoryManager::MemoryManager(std::unique_ptr<GarbageCollector> garbageCollector)
+    : gc(std::move(garbageCollector)), allocated(0), threshold(MIN_THRESHOLD), state(nullptr) {}
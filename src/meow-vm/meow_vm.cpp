@@ -1,6 +1,54 @@
 #include "meow-vm/meow_vm.h"
+#include "common/op_codes.h"
+#include "jit/trace.h"
+#include "memory/mark_sweep_gc.h"
+#include "runtime/chunk.h"
+#include "runtime/feedback.h"
+#include "runtime/native.h"
+#include "runtime/operators.h"
+#include "runtime/runtime_error.h"
+
+#include <thread>
 
 using namespace meow::vm;
+using namespace meow::common;
+using meow::runtime::FeedbackVector;
+using meow::runtime::RuntimeError;
+using meow::runtime::ScriptError;
+namespace operators = meow::runtime::operators;
+
+namespace {
+    inline uint16_t readShort(uint8_t*& ip) noexcept {
+        uint16_t value = static_cast<uint16_t>(ip[0] | (ip[1] << 8));
+        ip += 2;
+        return value;
+    }
+
+    inline int64_t readInt64(uint8_t*& ip) noexcept {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(ip[i]) << (i * 8);
+        }
+        ip += 8;
+        return static_cast<int64_t>(value);
+    }
+
+    // MEOW_CACHE_DIR, else the user's cache directory, empty if there is none or MEOW_CACHE=0
+    std::filesystem::path cacheDirectory() {
+        const char* enabled = std::getenv("MEOW_CACHE");
+        if (enabled && std::string_view(enabled) == "0") return {};
+        if (const char* dir = std::getenv("MEOW_CACHE_DIR")) return dir;
+        if (const char* xdg = std::getenv("XDG_CACHE_HOME")) return std::filesystem::path(xdg) / "meow-vm";
+        if (const char* home = std::getenv("HOME")) return std::filesystem::path(home) / ".cache" / "meow-vm";
+        if (const char* local = std::getenv("LOCALAPPDATA")) return std::filesystem::path(local) / "meow-vm";
+        return {};
+    }
+
+    // Rewrites the opcode byte of the instruction being executed
+    inline void quicken(uint8_t* instruction, OpCode op) noexcept {
+        *instruction = static_cast<uint8_t>(op);
+    }
+}
 
 MeowVM::MeowVM(const std::string& entry, int argc, char** argv) : entryPointDir(entry) {
     commandLineArgs.reserve(argc);
@@ -8,8 +56,1166 @@ MeowVM::MeowVM(const std::string& entry, int argc, char** argv) : entryPointDir(
     for (int i = 0; i < argc; ++i) {
         commandLineArgs.push_back(argv[i]);
     }
+
+    state.callStack.reserve(64);
+    heap = std::make_unique<meow::memory::MemoryManager>(std::make_unique<meow::memory::MarkSweepGC>());
+    heap->setState(&state);
+    modules = std::make_unique<meow::runtime::module::ModuleManager>(*heap, state, entryPointDir.empty() ? std::filesystem::current_path() : std::filesystem::path(entryPointDir));
+
+    setCacheDirectory(cacheDirectory());
+
+    const char* jit = std::getenv("MEOW_JIT");
+    jitEnabled = !(jit && std::string_view(jit) == "0");
+    topTier = jitEnabled ? Tier::COMPILED : Tier::QUICKENED;
+    jitBackend = jit && std::string_view(jit) == "threaded" ? meow::jit::Backend::THREADED : meow::jit::defaultBackend();
+
+    const char* lazy = std::getenv("MEOW_LAZY_IMPORTS");
+    lazyImports = lazy && std::string_view(lazy) == "1";
+
+    const char* profile = std::getenv("MEOW_PROFILE");
+    if (profile) profilePath = profile;
+}
+
+void MeowVM::setJitEnabled(bool enabled) noexcept {
+    jitEnabled = enabled;
+    topTier = enabled ? Tier::COMPILED : Tier::QUICKENED;
+}
+
+void MeowVM::setLazyImports(bool enabled) noexcept {
+    lazyImports = enabled;
+}
+
+void MeowVM::setJitBackend(meow::jit::Backend backend) noexcept {
+    jitBackend = backend;
+}
+
+void MeowVM::defineStringBuilder(Module module) {
+    module->setGlobal("StringBuilder", meow::runtime::makeStringBuilder(*heap));
+}
+
+void MeowVM::setCompiler(meow::runtime::module::ModuleManager::Compiler compiler) {
+    modules->setCompiler(std::move(compiler));
+}
+
+void MeowVM::setCacheDirectory(const std::filesystem::path& directory) {
+    modules->setCache(directory.empty() ? nullptr : std::make_unique<meow::runtime::module::CompileCache>(directory));
+}
+
+void MeowVM::setFrontend(std::unique_ptr<meow::runtime::module::Frontend> frontend) {
+    modules->setFrontend(std::move(frontend));
 }
 
 void MeowVM::interpret(const std::string& entryPath) {
     state.reset();
-}
\ No newline at end of file
+    // Lazy imports are there to skip work on modules that aren't used, parsing them all up front would undo that
+    if (!lazyImports) modules->preload(entryPath, std::max(1u, std::thread::hardware_concurrency()));
+    runModule(modules->loadModule(entryPath, nullptr));
+}
+
+Module MeowVM::importModule(meow::runtime::module::ModuleRecord& record) {
+    if (!lazyImports) runModule(record);
+    return record.module;
+}
+
+void MeowVM::runModule(meow::runtime::module::ModuleRecord& record) {
+    using meow::runtime::module::ModuleState;
+    switch (record.state) {
+        case ModuleState::DECLARED:
+            modules->materialize(record);
+            [[fallthrough]];
+        case ModuleState::LOADED:
+            // Marked first, so an import cycle gets the module as far as it ran instead of running it again
+            record.state = ModuleState::EXECUTING;
+            record.module->setPending(false);
+            try {
+                execute(record.main);
+            } catch (const ScriptError& error) {
+                record.state = ModuleState::FAILED;
+                record.thrown = error.value;
+                record.message = error.what();
+                if (auto object = heapObject(record.thrown)) state.moduleRoots.push_back(object);
+                throw;
+            } catch (...) {
+                record.state = ModuleState::FAILED;
+                record.error = std::current_exception();
+                throw;
+            }
+            record.state = ModuleState::EXECUTED;
+            break;
+        case ModuleState::FAILED:
+            if (record.error) std::rethrow_exception(record.error);
+            throw ScriptError(record.thrown, record.message);
+        default:
+            break;
+    }
+}
+
+void MeowVM::forceModule(Module module) {
+    if (meow::runtime::module::ModuleRecord* record = modules->findRecord(module)) runModule(*record);
+}
+
+Value MeowVM::execute(Proto proto) {
+    if (!proto->linked) {
+        throw RuntimeError("cannot execute a proto that isn't linked to a module");
+    }
+
+    // The entry frame goes above the registers of the running frame, the slot below its window holds the callee
+    size_t base = 1;
+    if (!state.callStack.empty()) {
+        const CallFrame& caller = state.callStack.back();
+        base = caller.base + caller.proto->registers + 1;
+    }
+    state.ensureStack(base + proto->registers);
+    state.stackSlots[base - 1] = proto;
+
+    size_t entryDepth = state.callStack.size();
+    state.callStack.push_back(CallFrame{proto, nullptr, proto->chunk->data(), base, 0});
+    ++proto->invocations;
+    try {
+        Value result = run(entryDepth);
+        if (entryDepth == 0) writeProfile(proto);
+        return result;
+    } catch (...) {
+        closeUpvalues(state.stackSlots.data() + base);
+        state.callStack.resize(entryDepth);
+        if (entryDepth == 0) writeProfile(proto);
+        throw;
+    }
+}
+
+void MeowVM::writeProfile(Proto proto) const noexcept {
+    if (profilePath.empty()) return;
+    // Appends, so the profiles of every script a host runs end up side by side
+    std::ofstream out(profilePath, std::ios::app);
+    if (out) meow::runtime::dumpProfile(*proto, out);
+}
+
+Upvalue MeowVM::captureUpvalue(Value* slot) {
+    // The open list is sorted from the top of the stack down, so the search stops at the slot's position
+    Upvalue* link = &state.openUpvalues;
+    while (*link && (*link)->location > slot) {
+        link = &(*link)->next;
+    }
+    if (*link && (*link)->location == slot) {
+        return *link;
+    }
+
+    // Open upvalues are roots, so a collection here leaves the list and the link untouched
+    Upvalue created = heap->newObject<ObjUpvalue>(slot);
+    created->next = *link;
+    *link = created;
+    return created;
+}
+
+void MeowVM::closeUpvalues(Value* last) noexcept {
+    // Only the upvalues being closed are visited
+    while (state.openUpvalues && state.openUpvalues->location >= last) {
+        Upvalue upvalue = state.openUpvalues;
+        upvalue->close();
+        state.openUpvalues = upvalue->next;
+        upvalue->next = nullptr;
+    }
+}
+
+void MeowVM::compile(Proto proto) noexcept {
+    if (proto->compiled || proto->uncompilable) return;
+    try {
+        proto->compiled = meow::jit::compile(*proto, jitBackend).release();
+    } catch (...) {
+        // Out of executable memory or malformed code, the interpreter keeps running it
+    }
+    if (!proto->compiled) proto->uncompilable = true;
+}
+
+void MeowVM::tierUp(Proto proto) noexcept {
+    // Quickening only needs a little feedback, machine code needs the proto to be hot
+    if (proto->tier == Tier::INTERPRETED) {
+        if (proto->invocations >= meow::runtime::QUICKEN_INVOCATIONS || proto->backEdges >= meow::runtime::QUICKEN_BACK_EDGES) proto->tier = Tier::QUICKENED;
+    } else if (proto->invocations >= meow::jit::INVOCATION_THRESHOLD || proto->backEdges >= meow::jit::BACK_EDGE_THRESHOLD) {
+        compile(proto);
+        proto->tier = Tier::COMPILED;
+    }
+}
+
+Value MeowVM::run(size_t entryDepth) {
+    CallFrame* frame;
+    Value* regs;
+    uint8_t* code;
+    const Value* constants;
+    Module globals;
+    uint8_t* ip;
+
+    // Reloads the cached state of the innermost frame after a call or a return
+    auto enterFrame = [&]() {
+        frame = &state.callStack.back();
+        regs = state.stackSlots.data() + frame->base;
+        code = frame->proto->chunk->data();
+        constants = frame->proto->chunk->constants();
+        globals = frame->proto->module;
+        ip = frame->ip;
+    };
+    enterFrame();
+    uint8_t* instruction = ip;
+
+    // The profile of the innermost frame's proto, allocated on first use
+    auto feedback = [&]() -> FeedbackVector& {
+        Proto proto = frame->proto;
+        if (!proto->feedback) proto->feedback = new FeedbackVector(*proto);
+        return *proto->feedback;
+    };
+
+    // Records the operand types of the current instruction. Returns true if it may be quickened for them:
+    // its proto is warm, the instruction never saw other types and its quickened form didn't keep failing
+    auto observe = [&](const Value& lhs, const Value& rhs) -> bool {
+        uint32_t pc = static_cast<uint32_t>(instruction - code);
+        return feedback().observe(pc, lhs, rhs) && frame->proto->tier != Tier::INTERPRETED && meow::jit::maySpeculate(*frame->proto, pc);
+    };
+
+    // A quickened instruction whose guess failed goes back to its generic form, and counts it against the site
+    auto deoptimize = [&](OpCode generic) {
+        meow::jit::recordDeopt(*frame->proto, static_cast<uint32_t>(instruction - code));
+        quicken(instruction, generic);
+    };
+
+    // Continues the innermost frame in machine code, if it has any, until the code exits back to the interpreter.
+    // An error raised in machine code is rethrown here, as if the instruction it stopped at had raised it
+    auto runCompiled = [&]() {
+        meow::jit::CompiledCode* compiled = frame->proto->compiled;
+        if (!compiled) return;
+        meow::jit::JitContext context{regs, constants, globals, frame->closure, heap.get(), nullptr};
+        ip = code + compiled->run(context, static_cast<size_t>(ip - code));
+        if (context.pending) {
+            instruction = ip;
+            std::rethrow_exception(context.pending);
+        }
+    };
+
+    // Enters a proto whose register window starts at register 'first' of the current frame and holds 'argc' arguments.
+    // The compiler keeps calls at the top of the live registers, so the window may extend past the caller's registers
+    auto pushFrame = [&](Proto callee, Closure closure, size_t first, size_t argc, uint16_t dst) {
+        size_t base = frame->base + first;
+        state.ensureStack(base + callee->registers);
+        Value* window = state.stackSlots.data() + base;
+        for (size_t i = argc; i < callee->arity; ++i) {
+            window[i] = Null{};
+        }
+
+        ++callee->invocations;
+        if (callee->tier < topTier) tierUp(callee);
+
+        frame->ip = ip;
+        state.callStack.push_back(CallFrame{callee, closure, callee->chunk->data(), base, dst});
+        enterFrame();
+        if (jitEnabled) runCompiled();
+    };
+
+    // A tail call's callee takes over the current frame: its window moves down to register 0, and the caller's
+    // return register receives its result. The registers are about to be reused, so their upvalues are closed first
+    auto replaceFrame = [&](Proto callee, Closure closure, size_t first, size_t argc) {
+        if (state.openUpvalues && state.openUpvalues->location >= regs) {
+            closeUpvalues(regs);
+        }
+        for (size_t i = 0; i < argc; ++i) {
+            regs[i] = std::move(regs[first + i]);
+        }
+        state.ensureStack(frame->base + callee->registers);
+        for (size_t i = argc; i < callee->arity; ++i) {
+            regs[i] = Null{};
+        }
+
+        ++callee->invocations;
+        if (callee->tier < topTier) tierUp(callee);
+
+        frame->proto = callee;
+        frame->closure = closure;
+        frame->ip = callee->chunk->data();
+        enterFrame();
+        if (jitEnabled) runCompiled();
+    };
+
+    // Calls a function value on the window starting at register 'first', a method finds its receiver there.
+    // Natives run in place and leave their result in 'dst' right away
+    auto callFunction = [&](const Value& callee, size_t first, size_t argc, uint16_t dst) {
+        if (const Closure* closure = callee.get_if<Closure>()) {
+            pushFrame((*closure)->proto, *closure, first, argc, dst);
+        } else if (const Proto* proto = callee.get_if<Proto>()) {
+            pushFrame(*proto, nullptr, first, argc, dst);
+        } else if (const Native* native = callee.get_if<Native>()) {
+            meow::runtime::checkArguments(**native, regs + first, argc);
+            Value result = (*native)->function(*heap, regs + first);
+            regs[dst] = std::move(result);
+        } else {
+            throw RuntimeError("'" + operators::typeName(callee) + "' is not callable");
+        }
+    };
+
+    // CALL of anything but a closure or a proto. The receiver of a bound method or a constructor takes the register
+    // of the callee, right below the arguments, so it becomes the first register of the method without moving them
+    auto callObject = [&](uint16_t dst, uint16_t fn, uint16_t argc) {
+        if (Native* native = regs[fn].get_if<Native>()) {
+            meow::runtime::checkArguments(**native, regs + fn + 1, argc);
+            Value result = (*native)->function(*heap, regs + fn + 1);
+            regs[dst] = std::move(result);
+        } else if (BoundMethod* bound = regs[fn].get_if<BoundMethod>()) {
+            Value method = (*bound)->method;
+            regs[fn] = (*bound)->receiver;
+            callFunction(method, fn, argc + 1, dst);
+        } else if (Class* klass = regs[fn].get_if<Class>()) {
+            const Value* init = (*klass)->findMethod("init");
+            if (!init && argc > 0) {
+                throw RuntimeError("'" + (*klass)->name + "' expects 0 arguments, got " + std::to_string(argc));
+            }
+            regs[fn] = heap->newObject<ObjInstance>(*klass);
+            if (init) {
+                callFunction(*init, fn, argc + 1, dst);
+            } else {
+                regs[dst] = regs[fn];
+            }
+        } else {
+            throw RuntimeError("'" + operators::typeName(regs[fn]) + "' is not callable");
+        }
+    };
+
+    // Looks a method up through the inline cache of the current instruction, which skips the hash probe
+    // as long as the site keeps seeing the same class and that class's methods didn't change
+    auto cachedMethod = [&](Class klass, const std::string& name) -> const Value& {
+        meow::runtime::MethodSite* site = feedback().methodSite(static_cast<uint32_t>(instruction - code));
+        if (site->klass != klass || site->version != klass->version || site->epoch != ObjClass::hierarchyEpoch) [[unlikely]] {
+            const Value* method = klass->findMethod(name);
+            if (!method) throw RuntimeError("'" + klass->name + "' has no method '" + name + "'");
+            if (site->klass) ++site->misses;
+            site->klass = klass;
+            site->version = klass->version;
+            site->epoch = ObjClass::hierarchyEpoch;
+            site->method = *method;
+        }
+        return site->method;
+    };
+
+    // Calls the callee in register 'fn' with the 'argc' arguments after it
+    auto call = [&](uint16_t dst, uint16_t fn, uint16_t argc) {
+        Proto callee;
+        Closure closure = nullptr;
+        if (Closure* target = regs[fn].get_if<Closure>()) {
+            closure = *target;
+            callee = closure->proto;
+        } else if (Proto* target = regs[fn].get_if<Proto>()) {
+            callee = *target;
+        } else {
+            callObject(dst, fn, argc);
+            return;
+        }
+
+        // Call targets only matter to the JIT, so compiled callers stop recording them
+        if (frame->proto->tier != Tier::COMPILED) feedback().observeCall(static_cast<uint32_t>(instruction - code), callee);
+        pushFrame(callee, closure, fn + 1, argc, dst);
+    };
+
+    // Hot loops are recorded on their back-edge, and run as traces from then on. A failing guard deoptimizes
+    // to the interpreter at the guarded instruction. Returns false if the loop can't be traced
+    auto runTrace = [&]() -> bool {
+        Proto proto = frame->proto;
+        if (!proto->traces) proto->traces = new meow::jit::LoopTraces();
+        auto& loop = proto->traces->loops[static_cast<uint32_t>(ip - code)];
+        if (loop.blacklisted) return false;
+
+        meow::jit::JitContext context{regs, constants, globals, frame->closure, heap.get(), nullptr};
+        if (loop.trace) {
+            // Lazy deoptimization: a trace whose assumptions broke is only dropped once the loop comes back to it
+            uint32_t failedSite;
+            if (const meow::jit::GlobalAssumption* broken = loop.trace->brokenAssumption(globals)) {
+                failedSite = broken->pc;
+            } else {
+                ip = code + loop.trace->run(context);
+                if (loop.trace->earlyExits <= meow::jit::MAX_EARLY_EXITS) return true;
+                failedSite = static_cast<uint32_t>(ip - code);  // The guard that keeps failing
+            }
+            meow::jit::recordDeopt(*proto, failedSite);
+            loop.trace.reset();
+            if (++loop.aborts >= meow::jit::MAX_TRACE_ABORTS) loop.blacklisted = true;
+            return true;
+        }
+        if (++loop.hits < meow::jit::HOT_LOOP_THRESHOLD) return true;
+
+        size_t resumePc;
+        loop.trace = meow::jit::recordTrace(context, *proto, static_cast<uint32_t>(ip - code), resumePc);
+        loop.hits = 0;
+        if (!loop.trace && ++loop.aborts >= meow::jit::MAX_TRACE_ABORTS) loop.blacklisted = true;
+        ip = code + resumePc;
+        if (context.pending) {
+            instruction = ip;
+            std::rethrow_exception(context.pending);
+        }
+        return true;
+    };
+
+    // Taken at every backward jump: counts towards tiering up, then continues the loop in the fastest code it has.
+    // A trace is specialized to the path the loop takes, so it comes first. Compiled code is entered by on-stack
+    // replacement: it works on the same register window, so the frame moves over at the loop header as it is
+    auto backEdge = [&]() {
+        ++frame->proto->backEdges;
+        if (frame->proto->tier < topTier) tierUp(frame->proto);
+        if (!jitEnabled) return;
+        if (!runTrace()) runCompiled();
+    };
+
+    // Searches the exception tables from the innermost frame outwards and resumes at the first handler covering the pc.
+    // Returns false once every frame of this run is unwound without finding one
+    auto unwind = [&](const Value& thrown, size_t pc) -> bool {
+        for (;;) {
+            for (const auto& entry : frame->proto->handlers) {
+                if (entry.start <= pc && pc < entry.end) {
+                    regs[entry.errorRegister] = thrown;
+                    ip = code + entry.handler;
+                    return true;
+                }
+            }
+            closeUpvalues(regs);
+            state.callStack.pop_back();
+            if (state.callStack.size() == entryDepth) {
+                return false;
+            }
+            enterFrame();
+            pc = static_cast<size_t>(ip - code) - 1;    // Inside the call being unwound
+        }
+    };
+
+    // Protected regions cost nothing until something is thrown, the handlers are only looked up on the way out
+    for (;;) {
+        try {
+            for (;;) {
+                instruction = ip;
+                switch (static_cast<OpCode>(*ip++)) {
+                    case OpCode::LOAD_CONST: {
+                        uint16_t dst = readShort(ip);
+                        regs[dst] = constants[readShort(ip)];
+                        break;
+                    }
+                    case OpCode::LOAD_NULL: regs[readShort(ip)] = Null{}; break;
+                    case OpCode::LOAD_TRUE: regs[readShort(ip)] = true; break;
+                    case OpCode::LOAD_FALSE: regs[readShort(ip)] = false; break;
+                    case OpCode::LOAD_INT: {
+                        uint16_t dst = readShort(ip);
+                        regs[dst] = static_cast<Int>(readInt64(ip));
+                        break;
+                    }
+                    case OpCode::MOVE: {
+                        uint16_t dst = readShort(ip);
+                        regs[dst] = regs[readShort(ip)];
+                        break;
+                    }
+
+                    // Global operands are slot indices resolved by the linker
+                    case OpCode::GET_GLOBAL: {
+                        uint16_t dst = readShort(ip), slot = readShort(ip);
+                        const GlobalCell& cell = globals->cell(slot);
+                        if (!cell.defined) [[unlikely]] {
+                            throw RuntimeError("undefined global '" + globals->globalName(slot) + "'");
+                        }
+                        regs[dst] = cell.value;
+                        break;
+                    }
+                    case OpCode::SET_GLOBAL: {
+                        uint16_t slot = readShort(ip), src = readShort(ip);
+                        globals->cell(slot).assign(regs[src]);
+                        break;
+                    }
+
+                    // Generic arithmetic records the operand types, and quickens itself for the next run once its proto is warm
+                    case OpCode::ADD: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (observe(regs[a], regs[b])) {
+                            if (regs[a].is<Int>() && regs[b].is<Int>()) quicken(instruction, OpCode::ADD_INT_INT);
+                            else if (regs[a].is<Float>() && regs[b].is<Float>()) quicken(instruction, OpCode::ADD_FLOAT_FLOAT);
+                        }
+                        // s = s + x drops the old string, so the result may take its buffer over
+                        if (dst == a && regs[a].is<String>()) {
+                            regs[dst] = operators::append(*heap, regs[a].get<String>(), regs[b]);
+                            break;
+                        }
+                        regs[dst] = operators::add(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::SUB: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (observe(regs[a], regs[b])) {
+                            if (regs[a].is<Int>() && regs[b].is<Int>()) quicken(instruction, OpCode::SUB_INT_INT);
+                            else if (regs[a].is<Float>() && regs[b].is<Float>()) quicken(instruction, OpCode::SUB_FLOAT_FLOAT);
+                        }
+                        regs[dst] = operators::subtract(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::MUL: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (observe(regs[a], regs[b])) {
+                            if (regs[a].is<Int>() && regs[b].is<Int>()) quicken(instruction, OpCode::MUL_INT_INT);
+                            else if (regs[a].is<Float>() && regs[b].is<Float>()) quicken(instruction, OpCode::MUL_FLOAT_FLOAT);
+                        }
+                        regs[dst] = operators::multiply(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::DIV: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::divide(regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::MOD: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::modulo(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::POW: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::power(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::EQ: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (observe(regs[a], regs[b]) && regs[a].is<Int>() && regs[b].is<Int>()) quicken(instruction, OpCode::EQ_INT_INT);
+                        regs[dst] = operators::equals(regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::NEQ: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = !operators::equals(regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::GT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::lessThan(regs[b], regs[a]);
+                        break;
+                    }
+                    case OpCode::GE: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::lessEqual(regs[b], regs[a]);
+                        break;
+                    }
+                    case OpCode::LT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (observe(regs[a], regs[b])) {
+                            if (regs[a].is<Int>() && regs[b].is<Int>()) quicken(instruction, OpCode::LT_INT_INT);
+                            else if (regs[a].is<Float>() && regs[b].is<Float>()) quicken(instruction, OpCode::LT_FLOAT_FLOAT);
+                        }
+                        regs[dst] = operators::lessThan(regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::LE: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::lessEqual(regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::NEG: {
+                        uint16_t dst = readShort(ip), src = readShort(ip);
+                        observe(regs[src], Null{});
+                        regs[dst] = operators::negate(*heap, regs[src]);
+                        break;
+                    }
+                    case OpCode::NOT: {
+                        uint16_t dst = readShort(ip);
+                        regs[dst] = !regs[readShort(ip)].asBool();
+                        break;
+                    }
+
+                    case OpCode::BIT_AND: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::bitAnd(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::BIT_OR: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::bitOr(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::BIT_XOR: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::bitXor(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::BIT_NOT: {
+                        uint16_t dst = readShort(ip), src = readShort(ip);
+                        observe(regs[src], Null{});
+                        regs[dst] = operators::bitNot(*heap, regs[src]);
+                        break;
+                    }
+                    case OpCode::LSHIFT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::shiftLeft(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::RSHIFT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        observe(regs[a], regs[b]);
+                        regs[dst] = operators::shiftRight(*heap, regs[a], regs[b]);
+                        break;
+                    }
+
+                    case OpCode::JUMP: {
+                        ip = code + readShort(ip);
+                        if (ip < instruction) backEdge();
+                        break;
+                    }
+                    case OpCode::JUMP_IF_FALSE: {
+                        uint16_t cond = readShort(ip), target = readShort(ip);
+                        if (!regs[cond].asBool()) ip = code + target;
+                        break;
+                    }
+                    case OpCode::JUMP_IF_TRUE: {
+                        uint16_t cond = readShort(ip), target = readShort(ip);
+                        if (regs[cond].asBool()) ip = code + target;
+                        break;
+                    }
+                    // Counted loops check their operands once. FORPREP turns the limit into the number of iterations left
+                    // after the current one, which can't overflow, so FORLOOP is a decrement, an add and a branch
+                    case OpCode::FORPREP: {
+                        uint16_t a = readShort(ip), exit = readShort(ip);
+                        if (!regs[a].is<Int>() || !regs[a + 1].is<Int>() || !regs[a + 2].is<Int>()) [[unlikely]] {
+                            throw RuntimeError("'for' loop bounds must be integers");
+                        }
+                        Int start = regs[a].get<Int>(), limit = regs[a + 1].get<Int>(), step = regs[a + 2].get<Int>();
+                        if (step == 0) throw RuntimeError("'for' loop step can't be zero");
+                        if (step > 0 ? start >= limit : start <= limit) {
+                            ip = code + exit;
+                            break;
+                        }
+                        uint64_t distance = step > 0 ? static_cast<uint64_t>(limit) - static_cast<uint64_t>(start) : static_cast<uint64_t>(start) - static_cast<uint64_t>(limit);
+                        uint64_t stride = step > 0 ? static_cast<uint64_t>(step) : 0 - static_cast<uint64_t>(step);
+                        regs[a + 1] = static_cast<Int>((distance - 1) / stride);    // Unsigned, the count may not fit an Int
+                        regs[a + 3] = start;
+                        break;
+                    }
+                    case OpCode::FORLOOP: {
+                        uint16_t a = readShort(ip), body = readShort(ip);
+                        uint64_t left = static_cast<uint64_t>(regs[a + 1].get<Int>());
+                        if (left != 0) {
+                            Int index = static_cast<Int>(static_cast<uint64_t>(regs[a].get<Int>()) + static_cast<uint64_t>(regs[a + 2].get<Int>()));
+                            regs[a] = index;
+                            regs[a + 1] = static_cast<Int>(left - 1);
+                            regs[a + 3] = index;
+                            ip = code + body;
+                            backEdge();
+                        }
+                        break;
+                    }
+                    case OpCode::CALL: {
+                        uint16_t dst = readShort(ip), fn = readShort(ip), argc = readShort(ip);
+                        call(dst, fn, argc);
+                        break;
+                    }
+                    // Anything but a script function is called as CALL fn, fn, argc, the RETURN fn after it returns its result
+                    case OpCode::TAIL_CALL: {
+                        uint16_t fn = readShort(ip), argc = readShort(ip);
+                        Proto callee;
+                        Closure closure = nullptr;
+                        if (Closure* target = regs[fn].get_if<Closure>()) {
+                            closure = *target;
+                            callee = closure->proto;
+                        } else if (Proto* target = regs[fn].get_if<Proto>()) {
+                            callee = *target;
+                        } else {
+                            call(fn, fn, argc);
+                            break;
+                        }
+                        if (frame->proto->tier != Tier::COMPILED) feedback().observeCall(static_cast<uint32_t>(instruction - code), callee);
+                        replaceFrame(callee, closure, fn + 1, argc);
+                        break;
+                    }
+                    case OpCode::RETURN: {
+                        Value result = regs[readShort(ip)];
+                        uint16_t dst = frame->returnRegister;
+                        if (state.openUpvalues && state.openUpvalues->location >= regs) {
+                            closeUpvalues(regs);
+                        }
+                        state.callStack.pop_back();
+                        if (state.callStack.size() == entryDepth) {
+                            return result;
+                        }
+                        enterFrame();
+                        regs[dst] = result;
+                        if (jitEnabled) runCompiled();
+                        break;
+                    }
+                    // Frames above the entry may still hold registers captured by closures, which must stop pointing into the stack
+                    case OpCode::HALT:
+                        closeUpvalues(state.stackSlots.data() + state.callStack[entryDepth].base);
+                        state.callStack.resize(entryDepth);
+                        return Null{};
+
+                    case OpCode::THROW: {
+                        Value thrown = regs[readShort(ip)];
+                        if (!unwind(thrown, static_cast<size_t>(instruction - code))) {
+                            throw ScriptError(thrown, thrown.asString());
+                        }
+                        break;
+                    }
+                    // Markers for the linker, which turns them into the exception table
+                    case OpCode::SETUP_TRY: ip += 4; break;
+                    case OpCode::POP_TRY: break;
+
+                    case OpCode::CLOSURE: {
+                        uint16_t dst = readShort(ip);
+                        Proto proto = constants[readShort(ip)].get<Proto>();
+                        Closure closure = heap->newTrailingObject<ObjClosure>(proto->upvalues, proto);
+
+                        // Capturing may allocate open upvalues, keep the closure alive meanwhile
+                        state.tempRoots.push_back(closure);
+                        Value* captured = closure->upvalues();
+                        for (size_t i = 0; i < proto->upvalues; ++i) {
+                            const UpvalueDesc& desc = proto->upvalueDescs[i];
+                            if (!desc.isLocal) {
+                                // Shares whatever the enclosing closure holds, a flat value or the same box
+                                captured[i] = frame->closure->upvalues()[desc.index];
+                            } else if (desc.byValue) {
+                                captured[i] = regs[desc.index];
+                            } else {
+                                captured[i] = captureUpvalue(regs + desc.index);
+                            }
+                        }
+                        state.tempRoots.pop_back();
+                        regs[dst] = closure;
+                        break;
+                    }
+                    case OpCode::GET_UPVALUE: {
+                        uint16_t dst = readShort(ip);
+                        regs[dst] = frame->closure->getUpvalue(readShort(ip));
+                        break;
+                    }
+                    case OpCode::SET_UPVALUE: {
+                        uint16_t index = readShort(ip);
+                        frame->closure->setUpvalue(index, regs[readShort(ip)]);
+                        break;
+                    }
+                    case OpCode::CLOSE_UPVALUES: {
+                        closeUpvalues(regs + readShort(ip));
+                        break;
+                    }
+
+                    case OpCode::NEW_ARRAY: {
+                        uint16_t dst = readShort(ip), start = readShort(ip), count = readShort(ip);
+                        regs[dst] = heap->newObject<ObjArray>(std::vector<Value>(regs + start, regs + start + count));
+                        break;
+                    }
+                    case OpCode::NEW_HASH: {
+                        uint16_t dst = readShort(ip), start = readShort(ip), count = readShort(ip);
+                        Object object = heap->newObject<ObjHash>();
+                        for (uint16_t i = 0; i < count; ++i) {
+                            operators::setIndex(object, regs[start + 2 * i], regs[start + 2 * i + 1]);
+                        }
+                        regs[dst] = object;
+                        break;
+                    }
+                    case OpCode::GET_INDEX: {
+                        uint16_t dst = readShort(ip), src = readShort(ip), key = readShort(ip);
+                        if (observe(regs[src], regs[key]) && regs[src].is<Array>() && regs[key].is<Int>()) {
+                            quicken(instruction, OpCode::GET_INDEX_ARRAY_INT);
+                        }
+                        regs[dst] = operators::getIndex(*heap, regs[src], regs[key]);
+                        break;
+                    }
+                    case OpCode::SET_INDEX: {
+                        uint16_t src = readShort(ip), key = readShort(ip), value = readShort(ip);
+                        observe(regs[src], regs[key]);
+                        operators::setIndex(regs[src], regs[key], regs[value]);
+                        break;
+                    }
+                    case OpCode::GET_KEYS: {
+                        uint16_t dst = readShort(ip), src = readShort(ip);
+                        if (!regs[src].is<Object>()) throw RuntimeError("keys() expects an object, not '" + operators::typeName(regs[src]) + "'");
+                        Object object = regs[src].get<Object>();
+                        Array keys = heap->newObject<ObjArray>();
+                        keys->reserve(object->size());
+
+                        // Allocating the key strings may collect, keep both arrays alive meanwhile
+                        state.tempRoots.push_back(object);
+                        state.tempRoots.push_back(keys);
+                        for (const auto& [key, value] : *object) {
+                            keys->push(heap->newObject<ObjString>(key));
+                        }
+                        state.tempRoots.resize(state.tempRoots.size() - 2);
+                        regs[dst] = keys;
+                        break;
+                    }
+                    case OpCode::GET_VALUES: {
+                        uint16_t dst = readShort(ip), src = readShort(ip);
+                        if (!regs[src].is<Object>()) throw RuntimeError("values() expects an object, not '" + operators::typeName(regs[src]) + "'");
+                        Object object = regs[src].get<Object>();
+                        Array values = heap->newObject<ObjArray>();
+                        values->reserve(object->size());
+                        for (const auto& [key, value] : *object) {
+                            values->push(value);
+                        }
+                        regs[dst] = values;
+                        break;
+                    }
+
+                    // An iteration keeps the container in register 'it' and the position of the current element in 'it + 1',
+                    // plus the size an object had when the loop started in 'it + 2'. Objects only grow by adding keys, which
+                    // may rehash and invalidate the position, so a size change is reported. Arrays are bounds-checked at each step
+                    case OpCode::ITER_PREP: {
+                        uint16_t it = readShort(ip), src = readShort(ip);
+                        if (const Array* array = regs[src].get_if<Array>()) {
+                            regs[it + 1] = Int{-1};
+                            regs[it + 2] = static_cast<Int>((*array)->size());
+                        } else if (const Object* object = regs[src].get_if<Object>()) {
+                            regs[it + 1] = ObjHash::endCursor();
+                            regs[it + 2] = static_cast<Int>((*object)->size());
+                        } else {
+                            throw RuntimeError("can't iterate over '" + operators::typeName(regs[src]) + "'");
+                        }
+                        regs[it] = regs[src];
+                        break;
+                    }
+                    case OpCode::ITER_NEXT: {
+                        uint16_t it = readShort(ip), dst = readShort(ip), exit = readShort(ip);
+                        if (Array* array = regs[it].get_if<Array>()) {
+                            if (static_cast<Int>((*array)->size()) != regs[it + 2].get<Int>()) [[unlikely]] {
+                                throw RuntimeError("array changed size during iteration");
+                            }
+                            Int next = regs[it + 1].get<Int>() + 1;
+                            if (static_cast<uint64_t>(next) < (*array)->size()) {
+                                regs[dst] = (*array)->get(static_cast<size_t>(next));
+                                regs[it + 1] = next;
+                            } else {
+                                ip = code + exit;
+                            }
+                            break;
+                        }
+                        Object object = regs[it].get<Object>();
+                        if (static_cast<Int>(object->size()) != regs[it + 2].get<Int>()) [[unlikely]] {
+                            throw RuntimeError("object changed size during iteration");
+                        }
+                        ObjHash::Cursor next = object->nextCursor(regs[it + 1].get<Int>());
+                        if (next != ObjHash::endCursor()) {
+                            regs[dst] = object->entryAt(next).second;
+                            regs[it + 1] = next;
+                        } else {
+                            ip = code + exit;
+                        }
+                        break;
+                    }
+                    // Only the keys that are read become strings
+                    case OpCode::ITER_KEY: {
+                        uint16_t dst = readShort(ip), it = readShort(ip);
+                        Int current = regs[it + 1].get<Int>();
+                        if (regs[it].is<Array>()) {
+                            regs[dst] = current;
+                        } else {
+                            Object object = regs[it].get<Object>();
+                            if (current == ObjHash::endCursor() || static_cast<Int>(object->size()) != regs[it + 2].get<Int>()) {
+                                throw RuntimeError("no current key to read");
+                            }
+                            regs[dst] = heap->newObject<ObjString>(object->entryAt(current).first);
+                        }
+                        break;
+                    }
+
+                    // Name operands are string constants, checked by the linker
+                    case OpCode::NEW_CLASS: {
+                        uint16_t dst = readShort(ip);
+                        regs[dst] = heap->newObject<ObjClass>(constants[readShort(ip)].get<String>()->get());
+                        break;
+                    }
+                    case OpCode::SET_METHOD: {
+                        uint16_t target = readShort(ip), name = readShort(ip), method = readShort(ip);
+                        if (!regs[target].is<Class>()) throw RuntimeError("can't define a method on '" + operators::typeName(regs[target]) + "'");
+                        regs[target].get<Class>()->setMethod(constants[name].get<String>()->get(), regs[method]);
+                        break;
+                    }
+                    case OpCode::INHERIT: {
+                        uint16_t target = readShort(ip), parent = readShort(ip);
+                        if (!regs[target].is<Class>()) throw RuntimeError("'" + operators::typeName(regs[target]) + "' can't inherit");
+                        if (!regs[parent].is<Class>()) throw RuntimeError("can't inherit from '" + operators::typeName(regs[parent]) + "'");
+                        Class klass = regs[target].get<Class>();
+                        for (Class ancestor = regs[parent].get<Class>(); ancestor; ancestor = ancestor->superclass) {
+                            if (ancestor == klass) throw RuntimeError("'" + klass->name + "' can't inherit from itself");
+                        }
+                        klass->inherit(regs[parent].get<Class>());
+                        break;
+                    }
+                    // Running an imported module's body is a nested execution, the frame is reloaded after it.
+                    // The path operand names an import site, resolved when the module was linked
+                    case OpCode::IMPORT_MODULE: {
+                        uint16_t dst = readShort(ip);
+                        ImportSite& site = frame->proto->importSites[readShort(ip)];
+                        frame->ip = ip;
+                        if (!site.record) site.record = &modules->declareModule(constants[site.path].get<String>()->get(), globals);
+                        Module imported = importModule(*site.record);
+                        enterFrame();
+                        regs[dst] = imported;
+                        break;
+                    }
+                    // Export operands are resolved by the linker: EXPORT stores to a slot of its own module,
+                    // GET_EXPORT names a site of the proto remembering the module and slot it last read
+                    case OpCode::EXPORT: {
+                        uint16_t slot = readShort(ip), src = readShort(ip);
+                        globals->exportCell(slot).assign(regs[src]);
+                        break;
+                    }
+                    case OpCode::GET_EXPORT: {
+                        uint16_t dst = readShort(ip), src = readShort(ip);
+                        ExportSite& site = frame->proto->exportSites[readShort(ip)];
+                        const Module* held = regs[src].get_if<Module>();
+                        Module module = held ? *held : nullptr;
+                        if (module != site.module) [[unlikely]] {
+                            const std::string& name = constants[site.name].get<String>()->get();
+                            if (!module) throw RuntimeError("can't read export '" + name + "' of '" + operators::typeName(regs[src]) + "'");
+                            site.module = module;
+                            site.slot = static_cast<uint32_t>(module->resolveExport(name));
+                        }
+                        // A module imported lazily runs its body the first time one of its exports is missing
+                        if (!module->exportCell(site.slot).defined && module->isPending()) [[unlikely]] {
+                            frame->ip = ip;
+                            forceModule(module);
+                            enterFrame();
+                        }
+                        const GlobalCell& cell = module->exportCell(site.slot);
+                        if (!cell.defined) [[unlikely]] {
+                            throw RuntimeError("module '" + module->getName() + "' has no export '" + module->exportName(site.slot) + "'");
+                        }
+                        regs[dst] = cell.value;
+                        break;
+                    }
+                    case OpCode::IMPORT_ALL: {
+                        uint16_t src = readShort(ip);
+                        if (!regs[src].is<Module>()) throw RuntimeError("can't import from '" + operators::typeName(regs[src]) + "'");
+                        Module module = regs[src].get<Module>();
+                        if (module->isPending()) {
+                            frame->ip = ip;
+                            forceModule(module);
+                            enterFrame();
+                        }
+                        for (size_t slot = 0; slot < module->exportCount(); ++slot) {
+                            const GlobalCell& cell = module->exportCell(slot);
+                            if (cell.defined) globals->setGlobal(module->exportName(slot), cell.value);
+                        }
+                        break;
+                    }
+
+                    case OpCode::GET_PROP: {
+                        uint16_t dst = readShort(ip), src = readShort(ip);
+                        const std::string& name = constants[readShort(ip)].get<String>()->get();
+                        if (frame->proto->tier != Tier::COMPILED) feedback().observeProperty(static_cast<uint32_t>(instruction - code), regs[src]);
+                        if (Instance* instance = regs[src].get_if<Instance>()) {
+                            auto field = (*instance)->fields.find(name);
+                            if (field != (*instance)->fields.end()) {
+                                regs[dst] = field->second;
+                            } else if (const Value* method = (*instance)->klass->findMethod(name)) {
+                                // Only a method read as a value is bound, calls go through INVOKE
+                                regs[dst] = heap->newObject<ObjBoundMethod>(regs[src], *method);
+                            } else {
+                                throw RuntimeError("'" + (*instance)->klass->name + "' has no property '" + name + "'");
+                            }
+                        } else if (Class* klass = regs[src].get_if<Class>()) {
+                            const Value* method = (*klass)->findMethod(name);
+                            if (!method) throw RuntimeError("'" + (*klass)->name + "' has no method '" + name + "'");
+                            regs[dst] = *method;
+                        } else {
+                            throw RuntimeError("can't read property '" + name + "' of '" + operators::typeName(regs[src]) + "'");
+                        }
+                        break;
+                    }
+                    case OpCode::SET_PROP: {
+                        uint16_t target = readShort(ip);
+                        const std::string& name = constants[readShort(ip)].get<String>()->get();
+                        uint16_t value = readShort(ip);
+                        if (frame->proto->tier != Tier::COMPILED) feedback().observeProperty(static_cast<uint32_t>(instruction - code), regs[target]);
+                        if (!regs[target].is<Instance>()) {
+                            throw RuntimeError("can't set property '" + name + "' of '" + operators::typeName(regs[target]) + "'");
+                        }
+                        regs[target].get<Instance>()->fields[name] = regs[value];
+                        break;
+                    }
+                    // The superclass is in 'dst' and the receiver in the first register of the method running GET_SUPER
+                    case OpCode::GET_SUPER: {
+                        uint16_t dst = readShort(ip);
+                        const std::string& name = constants[readShort(ip)].get<String>()->get();
+                        if (!regs[dst].is<Class>()) throw RuntimeError("'super' must be a class, not '" + operators::typeName(regs[dst]) + "'");
+                        const Value& method = cachedMethod(regs[dst].get<Class>(), name);
+                        regs[dst] = heap->newObject<ObjBoundMethod>(regs[0], method);
+                        break;
+                    }
+                    // A super call without a bound method in between, the receiver takes the superclass's register
+                    case OpCode::SUPER_INVOKE: {
+                        uint16_t self = readShort(ip), name = readShort(ip), argc = readShort(ip);
+                        if (!regs[self].is<Class>()) throw RuntimeError("'super' must be a class, not '" + operators::typeName(regs[self]) + "'");
+                        const Value& method = cachedMethod(regs[self].get<Class>(), constants[name].get<String>()->get());
+                        regs[self] = regs[0];
+                        callFunction(method, self, argc + 1, self);
+                        break;
+                    }
+                    // A method call without a bound method in between
+                    case OpCode::INVOKE: {
+                        uint16_t self = readShort(ip), name = readShort(ip), argc = readShort(ip);
+                        const std::string& methodName = constants[name].get<String>()->get();
+                        Instance* instance = regs[self].get_if<Instance>();
+                        if (!instance) {
+                            if (StringBuilder* builder = regs[self].get_if<StringBuilder>()) {
+                                Value result = meow::runtime::invokeStringBuilder(*heap, *builder, methodName, regs + self + 1, argc);
+                                regs[self] = std::move(result);
+                                break;
+                            }
+                            throw RuntimeError("can't call method '" + methodName + "' of '" + operators::typeName(regs[self]) + "'");
+                        }
+
+                        // A field holding a function shadows the method, and is called without a receiver
+                        if (!(*instance)->fields.empty()) {
+                            auto field = (*instance)->fields.find(methodName);
+                            if (field != (*instance)->fields.end()) {
+                                regs[self] = field->second;
+                                call(self, self, argc);
+                                break;
+                            }
+                        }
+                        callFunction(cachedMethod((*instance)->klass, methodName), self, argc + 1, self);
+                        break;
+                    }
+
+                    // Quickened forms: one cheap guard, and a miss de-specializes back to the generic opcode
+                    case OpCode::ADD_INT_INT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        Int result;
+                        if (regs[a].is<Int>() && regs[b].is<Int>()) [[likely]] {
+                            if (!__builtin_add_overflow(regs[a].get<Int>(), regs[b].get<Int>(), &result)) [[likely]] {
+                                regs[dst] = result;
+                                break;
+                            }
+                        } else {
+                            deoptimize(OpCode::ADD);
+                        }
+                        regs[dst] = operators::add(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::ADD_FLOAT_FLOAT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (regs[a].is<Float>() && regs[b].is<Float>()) [[likely]] {
+                            regs[dst] = regs[a].get<Float>() + regs[b].get<Float>();
+                        } else {
+                            deoptimize(OpCode::ADD);
+                            regs[dst] = operators::add(*heap, regs[a], regs[b]);
+                        }
+                        break;
+                    }
+                    case OpCode::SUB_INT_INT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        Int result;
+                        if (regs[a].is<Int>() && regs[b].is<Int>()) [[likely]] {
+                            if (!__builtin_sub_overflow(regs[a].get<Int>(), regs[b].get<Int>(), &result)) [[likely]] {
+                                regs[dst] = result;
+                                break;
+                            }
+                        } else {
+                            deoptimize(OpCode::SUB);
+                        }
+                        regs[dst] = operators::subtract(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::SUB_FLOAT_FLOAT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (regs[a].is<Float>() && regs[b].is<Float>()) [[likely]] {
+                            regs[dst] = regs[a].get<Float>() - regs[b].get<Float>();
+                        } else {
+                            deoptimize(OpCode::SUB);
+                            regs[dst] = operators::subtract(*heap, regs[a], regs[b]);
+                        }
+                        break;
+                    }
+                    case OpCode::MUL_INT_INT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        Int result;
+                        if (regs[a].is<Int>() && regs[b].is<Int>()) [[likely]] {
+                            if (!__builtin_mul_overflow(regs[a].get<Int>(), regs[b].get<Int>(), &result)) [[likely]] {
+                                regs[dst] = result;
+                                break;
+                            }
+                        } else {
+                            deoptimize(OpCode::MUL);
+                        }
+                        regs[dst] = operators::multiply(*heap, regs[a], regs[b]);
+                        break;
+                    }
+                    case OpCode::MUL_FLOAT_FLOAT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (regs[a].is<Float>() && regs[b].is<Float>()) [[likely]] {
+                            regs[dst] = regs[a].get<Float>() * regs[b].get<Float>();
+                        } else {
+                            deoptimize(OpCode::MUL);
+                            regs[dst] = operators::multiply(*heap, regs[a], regs[b]);
+                        }
+                        break;
+                    }
+                    case OpCode::LT_INT_INT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (regs[a].is<Int>() && regs[b].is<Int>()) [[likely]] {
+                            regs[dst] = regs[a].get<Int>() < regs[b].get<Int>();
+                        } else {
+                            deoptimize(OpCode::LT);
+                            regs[dst] = operators::lessThan(regs[a], regs[b]);
+                        }
+                        break;
+                    }
+                    case OpCode::LT_FLOAT_FLOAT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (regs[a].is<Float>() && regs[b].is<Float>()) [[likely]] {
+                            regs[dst] = regs[a].get<Float>() < regs[b].get<Float>();
+                        } else {
+                            deoptimize(OpCode::LT);
+                            regs[dst] = operators::lessThan(regs[a], regs[b]);
+                        }
+                        break;
+                    }
+                    case OpCode::EQ_INT_INT: {
+                        uint16_t dst = readShort(ip), a = readShort(ip), b = readShort(ip);
+                        if (regs[a].is<Int>() && regs[b].is<Int>()) [[likely]] {
+                            regs[dst] = regs[a].get<Int>() == regs[b].get<Int>();
+                        } else {
+                            deoptimize(OpCode::EQ);
+                            regs[dst] = operators::equals(regs[a], regs[b]);
+                        }
+                        break;
+                    }
+                    case OpCode::GET_INDEX_ARRAY_INT: {
+                        uint16_t dst = readShort(ip), src = readShort(ip), key = readShort(ip);
+                        if (regs[src].is<Array>() && regs[key].is<Int>()) [[likely]] {
+                            Array array = regs[src].get<Array>();
+                            uint64_t index = static_cast<uint64_t>(regs[key].get<Int>());
+                            if (index < array->size()) [[likely]] {
+                                regs[dst] = array->get(index);
+                                break;
+                            }
+                        } else {
+                            deoptimize(OpCode::GET_INDEX);
+                        }
+                        regs[dst] = operators::getIndex(*heap, regs[src], regs[key]);
+                        break;
+                    }
+
+                    default:
+                        throw RuntimeError("unsupported instruction at offset " + std::to_string(instruction - code));
+                }
+            }
+        } catch (const ScriptError& error) {
+            // Already unwound to the entry of this run, let the caller handle it
+            if (state.callStack.size() == entryDepth) throw;
+            // A nested execute may have grown the call stack and moved the frames
+            enterFrame();
+            if (!unwind(error.value, static_cast<size_t>(instruction - code))) throw;
+        } catch (const RuntimeError& error) {
+            if (state.callStack.size() == entryDepth) throw;
+            enterFrame();
+            Value thrown = heap->newObject<ObjString>(error.what());
+            if (!unwind(thrown, static_cast<size_t>(instruction - code))) {
+                throw ScriptError(thrown, error.what());
+            }
+        }
+    }
+}
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file feedback.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript type feedback
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "runtime/feedback.h"
+#include "runtime/chunk.h"
+#include "common/op_codes.h"
+
+#include <unordered_set>
+
+using namespace meow::runtime;
+using namespace meow::common;
+
+namespace {
+    bool isTypeSite(OpCode op) noexcept {
+        switch (op) {
+            case OpCode::ADD: case OpCode::SUB: case OpCode::MUL: case OpCode::DIV: case OpCode::MOD: case OpCode::POW:
+            case OpCode::EQ: case OpCode::NEQ: case OpCode::GT: case OpCode::GE: case OpCode::LT: case OpCode::LE:
+            case OpCode::NEG:
+            case OpCode::BIT_AND: case OpCode::BIT_OR: case OpCode::BIT_XOR: case OpCode::BIT_NOT:
+            case OpCode::LSHIFT: case OpCode::RSHIFT:
+            case OpCode::GET_INDEX: case OpCode::SET_INDEX:
+                return true;
+            default:
+                // Quickened forms stand for the generic instruction they were rewritten from
+                return op >= OpCode::ADD_INT_INT && op < OpCode::TOTAL_OPCODES;
+        }
+    }
+
+    // Indexed by Value alternative, in declaration order
+    constexpr const char* TYPE_NAMES[] = {
+        "null", "int", "float", "bool", "bigint", "bytes", "string", "array", "object", "module", "proto", "closure", "upvalue", "native",
+        "class", "instance", "method", "builder"
+    };
+
+    void writeTypes(std::ostream& out, TypeSet types) {
+        if (!types) {
+            out << '-';
+            return;
+        }
+        bool first = true;
+        for (size_t i = 0; i < std::size(TYPE_NAMES); ++i) {
+            if (!(types & (1u << i))) continue;
+            if (!first) out << '|';
+            out << TYPE_NAMES[i];
+            first = false;
+        }
+    }
+
+    const char* tierName(Tier tier) noexcept {
+        switch (tier) {
+            case Tier::INTERPRETED: return "interpreted";
+            case Tier::QUICKENED: return "quickened";
+            default: return "compiled";
+        }
+    }
+}
+
+FeedbackVector::FeedbackVector(const ObjProto& proto) : siteAt(proto.chunk->size(), NO_SITE) {
+    const uint8_t* code = proto.chunk->data();
+    size_t size = proto.chunk->size();
+    for (size_t pc = 0; pc < size; pc += instructionSize(static_cast<OpCode>(code[pc]))) {
+        OpCode op = static_cast<OpCode>(code[pc]);
+        if (op == OpCode::CALL || op == OpCode::TAIL_CALL) {
+            siteAt[pc] = static_cast<uint16_t>(callSites.size());
+            callSites.push_back(CallSite{static_cast<uint32_t>(pc)});
+        } else if (op == OpCode::INVOKE || op == OpCode::SUPER_INVOKE || op == OpCode::GET_SUPER) {
+            siteAt[pc] = static_cast<uint16_t>(methodSites.size());
+            methodSites.push_back(MethodSite{static_cast<uint32_t>(pc)});
+        } else if (op == OpCode::GET_PROP || op == OpCode::SET_PROP) {
+            siteAt[pc] = static_cast<uint16_t>(propertySites.size());
+            propertySites.push_back(PropertySite{static_cast<uint32_t>(pc)});
+        } else if (isTypeSite(op)) {
+            siteAt[pc] = static_cast<uint16_t>(typeSites.size());
+            typeSites.push_back(TypeSite{static_cast<uint32_t>(pc)});
+        }
+    }
+}
+
+bool FeedbackVector::observe(uint32_t pc, const Value& lhs, const Value& rhs) noexcept {
+    TypeSite* site = const_cast<TypeSite*>(typeSite(pc));
+    if (!site) return false;
+    TypeSet left = typeOf(lhs), right = typeOf(rhs);
+    site->operands[0] |= left;
+    site->operands[1] |= right;
+    ++site->count;
+    return site->operands[0] == left && site->operands[1] == right;
+}
+
+void FeedbackVector::observeCall(uint32_t pc, Proto target) noexcept {
+    CallSite* site = const_cast<CallSite*>(callSite(pc));
+    if (!site) return;
+    for (auto& [proto, count] : site->targets) {
+        if (proto == target || !proto) {
+            proto = target;
+            ++count;
+            return;
+        }
+    }
+    ++site->others;
+}
+
+void FeedbackVector::observeProperty(uint32_t pc, const Value& receiver) noexcept {
+    PropertySite* site = const_cast<PropertySite*>(propertySite(pc));
+    if (!site) return;
+    site->receivers |= typeOf(receiver);
+    const Instance* instance = receiver.get_if<Instance>();
+    if (!instance) return;
+    for (auto& [klass, count] : site->classes) {
+        if (klass == (*instance)->klass || !klass) {
+            klass = (*instance)->klass;
+            ++count;
+            return;
+        }
+    }
+    ++site->others;
+}
+
+const TypeSite* FeedbackVector::typeSite(uint32_t pc) const noexcept {
+    uint16_t index = siteAt[pc];
+    return index < typeSites.size() && typeSites[index].pc == pc ? &typeSites[index] : nullptr;
+}
+
+const CallSite* FeedbackVector::callSite(uint32_t pc) const noexcept {
+    uint16_t index = siteAt[pc];
+    return index < callSites.size() && callSites[index].pc == pc ? &callSites[index] : nullptr;
+}
+
+const PropertySite* FeedbackVector::propertySite(uint32_t pc) const noexcept {
+    uint16_t index = siteAt[pc];
+    return index < propertySites.size() && propertySites[index].pc == pc ? &propertySites[index] : nullptr;
+}
+
+MethodSite* FeedbackVector::methodSite(uint32_t pc) noexcept {
+    uint16_t index = siteAt[pc];
+    return index < methodSites.size() && methodSites[index].pc == pc ? &methodSites[index] : nullptr;
+}
+
+void FeedbackVector::recordDeopt(uint32_t pc) {
+    for (auto& [offset, count] : deoptSites) {
+        if (offset == pc) {
+            ++count;
+            return;
+        }
+    }
+    deoptSites.emplace_back(pc, 1);
+}
+
+uint32_t FeedbackVector::deopts(uint32_t pc) const noexcept {
+    for (const auto& [offset, count] : deoptSites) {
+        if (offset == pc) return count;
+    }
+    return 0;
+}
+
+void FeedbackVector::trace(meow::memory::GCVisitor& visitor) {
+    for (auto& site : callSites) {
+        for (auto& [proto, count] : site.targets) {
+            if (proto) visitor.visitObject(proto);
+        }
+    }
+    for (auto& site : propertySites) {
+        for (auto& [klass, count] : site.classes) {
+            if (klass) visitor.visitObject(klass);
+        }
+    }
+    for (auto& site : methodSites) {
+        visitor.visitObject(site.klass);
+        visitor.visitValue(site.method);
+    }
+}
+
+void FeedbackVector::dump(std::ostream& out) const {
+    for (const auto& site : typeSites) {
+        if (!site.count) continue;
+        out << "  @" << site.pc << " types ";
+        writeTypes(out, site.operands[0]);
+        out << ' ';
+        writeTypes(out, site.operands[1]);
+        out << " x" << site.count << '\n';
+    }
+    for (const auto& site : callSites) {
+        if (!site.targets[0].first) continue;
+        out << "  @" << site.pc << " calls";
+        for (const auto& [proto, count] : site.targets) {
+            if (proto) out << " proto@" << static_cast<const void*>(proto) << " x" << count;
+        }
+        if (site.others) out << " others x" << site.others;
+        out << '\n';
+    }
+    for (const auto& site : propertySites) {
+        if (!site.receivers) continue;
+        out << "  @" << site.pc << " properties of ";
+        writeTypes(out, site.receivers);
+        for (const auto& [klass, count] : site.classes) {
+            if (klass) out << ' ' << klass->name << " x" << count;
+        }
+        if (site.others) out << " others x" << site.others;
+        out << '\n';
+    }
+    for (const auto& site : methodSites) {
+        if (!site.klass) continue;
+        out << "  @" << site.pc << " methods of " << site.klass->name << " misses x" << site.misses << '\n';
+    }
+    for (const auto& [offset, count] : deoptSites) {
+        out << "  @" << offset << " deopts x" << count << '\n';
+    }
+}
+
+void meow::runtime::dumpProfile(const ObjProto& proto, std::ostream& out) {
+    // Nested protos are reachable through the constants, shared ones are written once
+    std::vector<const ObjProto*> pending{&proto};
+    std::unordered_set<const ObjProto*> seen{&proto};
+    while (!pending.empty()) {
+        const ObjProto* current = pending.back();
+        pending.pop_back();
+        out << "proto@" << static_cast<const void*>(current) << " tier=" << tierName(current->tier)
+            << " invocations=" << current->invocations << " backEdges=" << current->backEdges << '\n';
+        if (current->feedback) current->feedback->dump(out);
+
+        const Value* constants = current->chunk->constants();
+        for (size_t i = current->chunk->constantCount(); i-- > 0;) {
+            if (const Proto* nested = constants[i].get_if<Proto>(); nested && seen.insert(*nested).second) {
+                pending.push_back(*nested);
+            }
+        }
+    }
+}
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file linker.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript bytecode linker
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "runtime/linker.h"
+#include "runtime/chunk.h"
+#include "runtime/runtime_error.h"
+#include "common/op_codes.h"
+
+using namespace meow::common;
+using meow::runtime::RuntimeError;
+
+namespace {
+    // Gets the global slot index of the name held by the string constant at operand offset
+    uint16_t resolveGlobalOperand(const meow::runtime::Chunk& chunk, size_t offset, Module module) {
+        Value constant = chunk.readConstant(chunk.readShortAt(offset));
+        const String* name = constant.get_if<String>();
+        if (!name) {
+            throw RuntimeError("global name operand at offset " + std::to_string(offset) + " isn't a string constant");
+        }
+
+        size_t slot = module->resolveGlobal((*name)->get());
+        if (slot > std::numeric_limits<uint16_t>::max()) {
+            throw RuntimeError("too many globals in module '" + module->getName() + "'");
+        }
+        return static_cast<uint16_t>(slot);
+    }
+
+    // Gets the export slot index, in the linked module, of the name held by the string constant at operand offset
+    uint16_t resolveExportOperand(const meow::runtime::Chunk& chunk, size_t offset, Module module) {
+        Value constant = chunk.readConstant(chunk.readShortAt(offset));
+        const String* name = constant.get_if<String>();
+        if (!name) {
+            throw RuntimeError("export name operand at offset " + std::to_string(offset) + " isn't a string constant");
+        }
+
+        size_t slot = module->resolveExport((*name)->get());
+        if (slot > std::numeric_limits<uint16_t>::max()) {
+            throw RuntimeError("too many exports in module '" + module->getName() + "'");
+        }
+        return static_cast<uint16_t>(slot);
+    }
+
+    // Adds a site for the name operand at offset, export or import, and gets its index
+    template <typename Site>
+    uint16_t allocateSite(const meow::runtime::Chunk& chunk, size_t offset, size_t firstSite, std::vector<Site>& sites) {
+        uint16_t name = chunk.readShortAt(offset);
+        if (name >= chunk.constantCount() || !chunk.readConstant(name).is<String>()) {
+            throw RuntimeError("name operand at offset " + std::to_string(offset) + " isn't a string constant");
+        }
+        if (firstSite + sites.size() > std::numeric_limits<uint16_t>::max()) {
+            throw RuntimeError("too many module instructions in a function");
+        }
+        sites.push_back(Site{name});
+        return static_cast<uint16_t>(firstSite + sites.size() - 1);
+    }
+
+    // Class and property instructions name what they touch with a string constant, the interpreter reads it unchecked
+    void checkNameOperand(const meow::runtime::Chunk& chunk, size_t offset) {
+        uint16_t index = chunk.readShortAt(offset);
+        if (index >= chunk.constantCount() || !chunk.readConstant(index).is<String>()) {
+            throw RuntimeError("name operand at offset " + std::to_string(offset) + " isn't a string constant");
+        }
+    }
+}
+
+namespace meow::runtime {
+    void link(Proto proto, Module module) {
+        if (proto->linked) return;
+
+        // Operands are only rewritten once the whole chunk checked out, so a proto that fails to link is left as it was
+        Chunk& chunk = *proto->chunk;
+        std::vector<std::pair<size_t, uint16_t>> patches;
+        std::vector<ExceptionHandler> handlers;
+        std::vector<ExportSite> exportSites;
+        std::vector<ImportSite> importSites;
+        std::vector<size_t> openTries;
+        for (size_t offset = 0; offset < chunk.size(); offset += instructionSize(static_cast<OpCode>(chunk.data()[offset]))) {
+            switch (static_cast<OpCode>(chunk.data()[offset])) {
+                case OpCode::GET_GLOBAL:
+                    patches.emplace_back(offset + 3, resolveGlobalOperand(chunk, offset + 3, module));
+                    break;
+                case OpCode::SET_GLOBAL:
+                    patches.emplace_back(offset + 1, resolveGlobalOperand(chunk, offset + 1, module));
+                    break;
+                case OpCode::GET_PROP:
+                    checkNameOperand(chunk, offset + 5);
+                    break;
+                case OpCode::GET_EXPORT:
+                    patches.emplace_back(offset + 5, allocateSite(chunk, offset + 5, proto->exportSites.size(), exportSites));
+                    break;
+                case OpCode::NEW_CLASS:
+                case OpCode::SET_PROP:
+                case OpCode::SET_METHOD:
+                case OpCode::GET_SUPER:
+                case OpCode::INVOKE:
+                case OpCode::SUPER_INVOKE:
+                    checkNameOperand(chunk, offset + 3);
+                    break;
+                case OpCode::IMPORT_MODULE:
+                    patches.emplace_back(offset + 3, allocateSite(chunk, offset + 3, proto->importSites.size(), importSites));
+                    break;
+                case OpCode::EXPORT:
+                    patches.emplace_back(offset + 1, resolveExportOperand(chunk, offset + 1, module));
+                    break;
+
+                // The frame a tail call gives up would take its handlers along, and natives return through the RETURN
+                case OpCode::TAIL_CALL: {
+                    size_t next = offset + instructionSize(OpCode::TAIL_CALL);
+                    if (!openTries.empty()) {
+                        throw RuntimeError("TAIL_CALL at offset " + std::to_string(offset) + " is inside a try block");
+                    }
+                    if (next + instructionSize(OpCode::RETURN) > chunk.size() || static_cast<OpCode>(chunk.data()[next]) != OpCode::RETURN
+                        || chunk.readShortAt(next + 1) != chunk.readShortAt(offset + 1)) {
+                        throw RuntimeError("TAIL_CALL at offset " + std::to_string(offset) + " isn't followed by RETURN of its callee register");
+                    }
+                    break;
+                }
+
+                // Try blocks become exception table entries, the markers cost nothing at runtime
+                case OpCode::SETUP_TRY:
+                    openTries.push_back(offset);
+                    break;
+                case OpCode::POP_TRY: {
+                    if (openTries.empty()) {
+                        throw RuntimeError("POP_TRY at offset " + std::to_string(offset) + " has no matching SETUP_TRY");
+                    }
+                    size_t setup = openTries.back();
+                    openTries.pop_back();
+                    handlers.push_back(ExceptionHandler{
+                        setup + instructionSize(OpCode::SETUP_TRY), offset,
+                        chunk.readShortAt(setup + 1), chunk.readShortAt(setup + 3)
+                    });
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        if (!openTries.empty()) {
+            throw RuntimeError("SETUP_TRY at offset " + std::to_string(openTries.back()) + " has no matching POP_TRY");
+        }
+
+        // Function literals are protos in the constant pool, each is linked on its own
+        for (size_t i = 0; i < chunk.constantCount(); ++i) {
+            if (const Proto* nested = chunk.constants()[i].get_if<Proto>()) {
+                link(*nested, module);
+            }
+        }
+
+        for (const auto& [operand, value] : patches) {
+            chunk.patchShort(operand, value);
+        }
+        proto->handlers.insert(proto->handlers.end(), handlers.begin(), handlers.end());
+        proto->exportSites.insert(proto->exportSites.end(), exportSites.begin(), exportSites.end());
+        proto->importSites.insert(proto->importSites.end(), importSites.begin(), importSites.end());
+        proto->module = module;
+        proto->linked = true;
+    }
+}
@@ -0,0 +1,312 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file compile_cache.cpp
+ * @author lazypaws
+ * @brief Implementation of the on-disk cache of compiled module bodies
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "runtime/module/compile_cache.h"
+#include "common/op_codes.h"
+#include "runtime/chunk.h"
+#include "runtime/runtime_error.h"
+
+#include <random>
+
+using namespace meow::runtime::module;
+using namespace meow::common;
+using meow::runtime::RuntimeError;
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char MAGIC[4] = {'M', 'E', 'O', 'W'};
+    // Set by the build to the release or commit the VM comes from. A build without it can't tell its entries
+    // from those of another build, so it doesn't cache at all
+#ifdef MEOW_VM_BUILD
+    constexpr std::string_view VM_BUILD = MEOW_VM_BUILD;
+#else
+    constexpr std::string_view VM_BUILD;
+#endif
+    // Deeper nesting of functions in an entry means it's corrupt, decoding it would only exhaust the stack
+    constexpr size_t MAX_NESTING = 256;
+
+    enum class ConstantTag : uint8_t {
+        NULL_VALUE, INT, FLOAT, BOOL, STRING, PROTO
+    };
+
+    // Fixed-width little-endian integers, so entries don't depend on the host
+    class Writer {
+    public:
+        void u8(uint8_t value) {
+            out.push_back(static_cast<char>(value));
+        }
+
+        void u32(uint32_t value) {
+            for (int i = 0; i < 4; ++i) u8(static_cast<uint8_t>(value >> (i * 8)));
+        }
+
+        void u64(uint64_t value) {
+            for (int i = 0; i < 8; ++i) u8(static_cast<uint8_t>(value >> (i * 8)));
+        }
+
+        void bytes(std::string_view data) {
+            u32(static_cast<uint32_t>(data.size()));
+            out.append(data);
+        }
+
+        std::string out;
+    };
+
+    class Reader {
+    public:
+        explicit Reader(std::string_view data) : data(data) {}
+
+        uint8_t u8() {
+            need(1);
+            return static_cast<uint8_t>(data[position++]);
+        }
+
+        uint32_t u32() {
+            uint32_t value = 0;
+            for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(u8()) << (i * 8);
+            return value;
+        }
+
+        uint64_t u64() {
+            uint64_t value = 0;
+            for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(u8()) << (i * 8);
+            return value;
+        }
+
+        std::string_view bytes() {
+            uint32_t size = u32();
+            need(size);
+            std::string_view result = data.substr(position, size);
+            position += size;
+            return result;
+        }
+
+        // A count of elements taking at least minimumSize bytes each, checked against what's left before anything is allocated
+        uint32_t count(size_t minimumSize) {
+            uint32_t value = u32();
+            need(value * minimumSize);
+            return value;
+        }
+
+        std::string_view rest() noexcept {
+            std::string_view result = data.substr(position);
+            position = data.size();
+            return result;
+        }
+    private:
+        void need(size_t size) {
+            if (data.size() - position < size) throw RuntimeError("truncated compile cache entry");
+        }
+
+        std::string_view data;
+        size_t position = 0;
+    };
+
+    // False if the proto holds a constant with no encoding, such as a BigInt
+    bool encodeProto(Writer& writer, const ObjProto& proto) {
+        writer.u64(proto.registers);
+        writer.u64(proto.upvalues);
+        writer.u64(proto.arity);
+        writer.u32(static_cast<uint32_t>(proto.upvalueDescs.size()));
+        for (const UpvalueDesc& desc : proto.upvalueDescs) {
+            writer.u8(desc.isLocal);
+            writer.u8(desc.byValue);
+            writer.u64(desc.index);
+        }
+
+        meow::runtime::Chunk& chunk = *proto.chunk;
+        writer.bytes(std::string_view(reinterpret_cast<const char*>(chunk.data()), chunk.size()));
+        writer.u32(static_cast<uint32_t>(chunk.constantCount()));
+        for (size_t i = 0; i < chunk.constantCount(); ++i) {
+            const Value& constant = chunk.constants()[i];
+            if (constant.is<Null>()) {
+                writer.u8(static_cast<uint8_t>(ConstantTag::NULL_VALUE));
+            } else if (const Int* integer = constant.get_if<Int>()) {
+                writer.u8(static_cast<uint8_t>(ConstantTag::INT));
+                writer.u64(static_cast<uint64_t>(*integer));
+            } else if (const Float* number = constant.get_if<Float>()) {
+                writer.u8(static_cast<uint8_t>(ConstantTag::FLOAT));
+                writer.u64(std::bit_cast<uint64_t>(*number));
+            } else if (const Bool* boolean = constant.get_if<Bool>()) {
+                writer.u8(static_cast<uint8_t>(ConstantTag::BOOL));
+                writer.u8(*boolean);
+            } else if (const String* string = constant.get_if<String>()) {
+                writer.u8(static_cast<uint8_t>(ConstantTag::STRING));
+                writer.bytes((*string)->get());
+            } else if (const Proto* nested = constant.get_if<Proto>()) {
+                writer.u8(static_cast<uint8_t>(ConstantTag::PROTO));
+                if (!encodeProto(writer, **nested)) return false;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Each proto roots itself while its constants are allocated, the caller drops the roots
+    Proto decodeProto(Reader& reader, meow::memory::MemoryManager& heap, meow::runtime::MeowState& state, size_t depth = 0) {
+        if (depth > MAX_NESTING) throw RuntimeError("functions nested too deeply in compile cache entry");
+        Proto proto = heap.newObject<ObjProto>();
+        proto->chunk = new meow::runtime::Chunk();
+        state.tempRoots.push_back(proto);
+        proto->registers = reader.u64();
+        proto->upvalues = reader.u64();
+        proto->arity = reader.u64();
+        proto->upvalueDescs.resize(reader.count(10));
+        for (UpvalueDesc& desc : proto->upvalueDescs) {
+            desc.isLocal = reader.u8();
+            desc.byValue = reader.u8();
+            desc.index = reader.u64();
+        }
+
+        for (char byte : reader.bytes()) proto->chunk->writeByte(static_cast<uint8_t>(byte));
+        uint32_t constants = reader.count(1);
+        for (uint32_t i = 0; i < constants; ++i) {
+            switch (static_cast<ConstantTag>(reader.u8())) {
+                case ConstantTag::NULL_VALUE:
+                    proto->chunk->addConstant(Null{});
+                    break;
+                case ConstantTag::INT:
+                    proto->chunk->addConstant(static_cast<Int>(reader.u64()));
+                    break;
+                case ConstantTag::FLOAT:
+                    proto->chunk->addConstant(std::bit_cast<Float>(reader.u64()));
+                    break;
+                case ConstantTag::BOOL:
+                    proto->chunk->addConstant(static_cast<Bool>(reader.u8()));
+                    break;
+                case ConstantTag::STRING:
+                    proto->chunk->addConstant(heap.newObject<ObjString>(std::string(reader.bytes())));
+                    break;
+                case ConstantTag::PROTO:
+                    proto->chunk->addConstant(decodeProto(reader, heap, state, depth + 1));
+                    break;
+                default:
+                    throw RuntimeError("unknown constant in compile cache entry");
+            }
+        }
+        return proto;
+    }
+
+    // The paths named by IMPORT_MODULE instructions, in the proto and the functions it defines
+    void collectImports(const ObjProto& proto, std::vector<std::string>& imports) {
+        meow::runtime::Chunk& chunk = *proto.chunk;
+        for (size_t offset = 0; offset < chunk.size(); offset += instructionSize(static_cast<OpCode>(chunk.data()[offset]))) {
+            if (static_cast<OpCode>(chunk.data()[offset]) != OpCode::IMPORT_MODULE) continue;
+            Value path = chunk.readConstant(chunk.readShortAt(offset + 3));
+            if (const String* name = path.get_if<String>()) imports.push_back((*name)->get());
+        }
+        for (size_t i = 0; i < chunk.constantCount(); ++i) {
+            if (const Proto* nested = chunk.constants()[i].get_if<Proto>()) collectImports(**nested, imports);
+        }
+    }
+}
+
+bool meow::runtime::module::isCacheSupported() noexcept {
+    return !VM_BUILD.empty();
+}
+
+CompileCache::CompileCache(fs::path directory) : directory(std::move(directory)) {}
+
+fs::path CompileCache::entryPath(const SourceFile& source) const {
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << source.fingerprint.hash << '-' << std::setw(16) << contentHash(VM_BUILD) << ".meowc";
+    return directory / name.str();
+}
+
+std::optional<CachedModule> CompileCache::read(const SourceFile& source) const noexcept {
+    if (!isCacheSupported()) return std::nullopt;
+    try {
+        std::ifstream in(entryPath(source), std::ios::binary);
+        if (!in) return std::nullopt;
+        std::ostringstream text;
+        text << in.rdbuf();
+        std::string data = text.str();
+
+        // An entry of another VM build, of a source that only shares the file name hash, or damaged on disk, reads as a miss
+        Reader header(data);
+        for (char c : MAGIC) {
+            if (header.u8() != static_cast<uint8_t>(c)) return std::nullopt;
+        }
+        if (header.u32() != CACHE_FORMAT_VERSION || header.u32() != static_cast<uint32_t>(OpCode::TOTAL_OPCODES)) return std::nullopt;
+        if (header.bytes() != VM_BUILD) return std::nullopt;
+        const Fingerprint& fingerprint = source.fingerprint;
+        if (header.u64() != fingerprint.size || header.u64() != fingerprint.hash || header.u64() != fingerprint.check) return std::nullopt;
+        uint64_t checksum = header.u64();
+        std::string_view payload = header.rest();
+        if (contentCheck(payload) != checksum) return std::nullopt;
+
+        Reader reader(payload);
+        CachedModule cached;
+        cached.imports.resize(reader.count(4));
+        for (std::string& import : cached.imports) import = reader.bytes();
+        cached.body = reader.rest();
+        return cached;
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+Proto CompileCache::decode(meow::memory::MemoryManager& heap, MeowState& state, const CachedModule& cached) const {
+    size_t rootCount = state.tempRoots.size();
+    try {
+        Reader reader(cached.body);
+        Proto main = decodeProto(reader, heap, state);
+        state.tempRoots.resize(rootCount);
+        return main;
+    } catch (...) {
+        state.tempRoots.resize(rootCount);
+        throw;
+    }
+}
+
+void CompileCache::store(const SourceFile& source, Proto main) const noexcept {
+    if (!isCacheSupported()) return;
+    try {
+        Writer payload;
+        std::vector<std::string> imports;
+        collectImports(*main, imports);
+        payload.u32(static_cast<uint32_t>(imports.size()));
+        for (const std::string& import : imports) payload.bytes(import);
+        if (!encodeProto(payload, *main)) return;
+
+        Writer writer;
+        for (char c : MAGIC) writer.u8(static_cast<uint8_t>(c));
+        writer.u32(CACHE_FORMAT_VERSION);
+        writer.u32(static_cast<uint32_t>(OpCode::TOTAL_OPCODES));
+        writer.bytes(VM_BUILD);
+        writer.u64(source.fingerprint.size);
+        writer.u64(source.fingerprint.hash);
+        writer.u64(source.fingerprint.check);
+        writer.u64(contentCheck(payload.out));
+        writer.out += payload.out;
+
+        // Renaming over the entry is atomic, a reader sees the old one or the new one and never a partial write
+        std::error_code error;
+        fs::create_directories(directory, error);
+        fs::path target = entryPath(source);
+        std::ostringstream suffix;
+        suffix << ".tmp" << std::hex << std::random_device{}() << std::random_device{}();
+        fs::path temporary = target;
+        temporary += suffix.str();
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out) return;
+            out.write(writer.out.data(), static_cast<std::streamsize>(writer.out.size()));
+            if (!out.flush()) {
+                out.close();
+                fs::remove(temporary, error);
+                return;
+            }
+        }
+        fs::rename(temporary, target, error);
+        if (error) fs::remove(temporary, error);
+    } catch (...) {
+        // The entry is only an optimization
+    }
+}
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file load_module.cpp
+ * @author lazypaws
+ * @brief Implementation of reading and fingerprinting module sources
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "runtime/module/load_module.h"
+#include "runtime/runtime_error.h"
+
+using namespace meow::runtime::module;
+using meow::runtime::RuntimeError;
+namespace fs = std::filesystem;
+
+uint64_t meow::runtime::module::contentHash(std::string_view text) noexcept {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t meow::runtime::module::contentCheck(std::string_view data) noexcept {
+    constexpr uint64_t PRIME1 = 0x9e3779b185ebca87ull, PRIME2 = 0xc2b2ae3d27d4eb4full;
+    uint64_t hash = PRIME2 ^ data.size();
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        uint64_t word = 0;
+        for (int j = 0; j < 8; ++j) word |= static_cast<uint64_t>(static_cast<unsigned char>(data[i + j])) << (j * 8);
+        hash = std::rotl(hash ^ (word * PRIME2), 31) * PRIME1;
+    }
+    for (; i < data.size(); ++i) hash = std::rotl(hash ^ (static_cast<unsigned char>(data[i]) * PRIME1), 11) * PRIME2;
+
+    // Finalizer of MurmurHash3, so every input bit reaches every output bit
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+SourceFile meow::runtime::module::readSource(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw RuntimeError("can't read module '" + path.string() + "'");
+    std::ostringstream text;
+    text << in.rdbuf();
+
+    SourceFile source{path.string(), text.str(), {}};
+    source.fingerprint.size = source.text.size();
+    source.fingerprint.hash = contentHash(source.text);
+    source.fingerprint.check = contentCheck(source.text);
+    return source;
+}
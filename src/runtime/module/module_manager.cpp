@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file module_manager.cpp
+ * @author lazypaws
+ * @brief Implementation of the MeowScript module manager
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "runtime/module/module_manager.h"
+#include "runtime/chunk.h"
+#include "runtime/linker.h"
+#include "runtime/runtime_error.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+using namespace meow::runtime::module;
+using namespace meow::common;
+using meow::runtime::RuntimeError;
+namespace fs = std::filesystem;
+
+namespace {
+    // Lexical only, so a path seen before is found without touching the file system
+    fs::path importKey(const std::string& modulePath, const fs::path& directory) {
+        fs::path written(modulePath);
+        if (!written.has_extension()) written += ".meow";
+        return (directory / written).lexically_normal();
+    }
+
+    struct Parsed {
+        SourceFile source;
+        std::optional<CachedModule> cached;
+        std::unique_ptr<ParsedModule> module;
+    };
+}
+
+ModuleManager::ModuleManager(meow::memory::MemoryManager& heap, MeowState& state, fs::path baseDirectory)
+    : heap(heap), state(state), baseDirectory(std::move(baseDirectory)) {}
+
+void ModuleManager::setCompiler(Compiler target) {
+    compiler = std::move(target);
+}
+
+void ModuleManager::setFrontend(std::unique_ptr<Frontend> target) {
+    frontend = std::move(target);
+}
+
+void ModuleManager::setCache(std::unique_ptr<CompileCache> compileCache) {
+    cache = std::move(compileCache);
+}
+
+ModuleRecord& ModuleManager::loadModule(const std::string& modulePath, Module importer) {
+    ModuleRecord& record = declareModule(modulePath, importer);
+    if (record.state == ModuleState::DECLARED) materialize(record);
+    return record;
+}
+
+ModuleRecord& ModuleManager::declareModule(const std::string& modulePath, Module importer) {
+    fs::path directory = importer && !importer->getPath().empty() ? fs::path(importer->getPath()).parent_path() : baseDirectory;
+    std::string key = importKey(modulePath, directory).string();
+    if (auto found = imports.find(key); found != imports.end()) return *found->second;
+
+    std::error_code error;
+    fs::path canonical = fs::canonical(key, error);
+    if (error) throw RuntimeError("can't find module '" + modulePath + "' (" + key + ")");
+    ModuleRecord& record = declare(canonical.string());
+    imports.emplace(std::move(key), &record);
+    return record;
+}
+
+void ModuleManager::materialize(ModuleRecord& record) {
+    SourceFile source = readSource(record.module->getPath());
+    std::optional<CachedModule> cached = cache ? cache->read(source) : std::nullopt;
+    build(record, source, [&] { return decodeOrCompile(source, cached, [&] { return compile(source); }); });
+}
+
+ModuleRecord* ModuleManager::findRecord(Module module) noexcept {
+    auto found = modules.find(module->getPath());
+    return found == modules.end() ? nullptr : found->second.get();
+}
+
+void ModuleManager::preload(const std::string& entryPath, unsigned threads) {
+    if (!frontend) return;
+    std::error_code error;
+    fs::path entry = fs::canonical(importKey(entryPath, baseDirectory), error);
+    if (error) return;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<fs::path> pending{entry};
+    std::unordered_set<std::string> seen{entry.string()};
+    for (const auto& [path, record] : modules) {
+        if (record->state != ModuleState::DECLARED) seen.insert(path);
+    }
+    std::vector<Parsed> parsed;
+    size_t busy = 0;
+
+    auto work = [&] {
+        std::unique_lock lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return !pending.empty() || busy == 0; });
+            if (pending.empty()) return;
+            fs::path path = std::move(pending.front());
+            pending.pop_front();
+            ++busy;
+            lock.unlock();
+
+            Parsed result;
+            std::vector<fs::path> found;
+            try {
+                result.source = readSource(path);
+                if (cache) result.cached = cache->read(result.source);
+                if (!result.cached) result.module = frontend->parse(result.source.text, result.source.path);
+                for (const std::string& import : result.cached ? result.cached->imports : result.module->imports) {
+                    std::error_code missing;
+                    fs::path canonical = fs::canonical(importKey(import, path.parent_path()), missing);
+                    if (!missing) found.push_back(std::move(canonical));
+                }
+            } catch (...) {
+                result.cached.reset();
+                result.module.reset();
+            }
+
+            lock.lock();
+            for (auto& canonical : found) {
+                if (seen.insert(canonical.string()).second) pending.push_back(std::move(canonical));
+            }
+            if (result.cached || result.module) parsed.push_back(std::move(result));
+            --busy;
+            wake.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) pool.emplace_back(work);
+    work();
+    for (auto& thread : pool) thread.join();
+
+    for (Parsed& result : parsed) {
+        ModuleRecord& record = declare(result.source.path);
+        if (record.state != ModuleState::DECLARED) continue;
+        try {
+            build(record, result.source, [&] {
+                return decodeOrCompile(result.source, result.cached, [&] {
+                    return result.module ? frontend->emit(*result.module) : compile(result.source);
+                });
+            });
+        } catch (const std::exception&) {
+            // Left DECLARED, loadModule compiles it again when it's imported and reports the error there
+        }
+    }
+}
+
+Proto ModuleManager::compile(const SourceFile& source) {
+    if (frontend) {
+        std::unique_ptr<ParsedModule> parsed = frontend->parse(source.text, source.path);
+        return frontend->emit(*parsed);
+    }
+    if (!compiler) throw RuntimeError("no compiler to load module '" + source.path + "'");
+    return compiler(source.text, source.path);
+}
+
+Proto ModuleManager::decodeOrCompile(const SourceFile& source, const std::optional<CachedModule>& cached, const std::function<Proto()>& emit) {
+    if (cached) {
+        try {
+            return cache->decode(heap, state, *cached);
+        } catch (...) {
+            // Whatever went wrong, the entry is only an optimization: compiled again and overwritten
+        }
+    }
+    Proto main = emit();
+    if (cache && main) cache->store(source, main);
+    return main;
+}
+
+ModuleRecord& ModuleManager::declare(const std::string& canonicalPath) {
+    auto [entry, inserted] = modules.try_emplace(canonicalPath);
+    if (!inserted) return *entry->second;
+    entry->second = std::make_unique<ModuleRecord>();
+    ModuleRecord& record = *entry->second;
+    record.module = heap.newObject<ObjModule>(fs::path(canonicalPath).stem().string(), canonicalPath);
+    record.module->setPending(true);
+    state.moduleRoots.push_back(record.module);
+    return record;
+}
+
+void ModuleManager::build(ModuleRecord& record, const SourceFile& source, const std::function<Proto()>& emit) {
+    Proto main = emit();
+    if (!main) throw RuntimeError("module '" + source.path + "' didn't compile");
+    state.moduleRoots.push_back(main);
+    try {
+        link(main, record.module);
+    } catch (...) {
+        state.moduleRoots.pop_back();
+        throw;
+    }
+    record.main = main;
+    record.state = ModuleState::LOADED;
+    resolveImports(main, record.module);
+}
+
+void ModuleManager::resolveImports(Proto main, Module importer) noexcept {
+    // Nested protos are reachable through the constants, shared ones are resolved once
+    std::vector<Proto> pending{main};
+    std::unordered_set<Proto> seen{main};
+    while (!pending.empty()) {
+        Proto proto = pending.back();
+        pending.pop_back();
+        const Value* constants = proto->chunk->constants();
+        for (ImportSite& site : proto->importSites) {
+            try {
+                site.record = &declareModule(constants[site.path].get<String>()->get(), importer);
+            } catch (...) {
+                // Left unresolved, the instruction resolves it again when it runs and reports the error there
+            }
+        }
+        for (size_t i = proto->chunk->constantCount(); i-- > 0;) {
+            if (const Proto* nested = constants[i].get_if<Proto>(); nested && seen.insert(*nested).second) {
+                pending.push_back(*nested);
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file native.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript native function bindings
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "runtime/native.h"
+#include "runtime/operators.h"
+#include "runtime/runtime_error.h"
+
+using namespace meow::runtime;
+using namespace meow::common;
+
+void meow::runtime::checkArguments(const ObjNative& native, const Value* args, size_t argc) {
+    if (argc != native.arity) {
+        throw RuntimeError("'" + native.name + "' expects " + std::to_string(native.arity) + " arguments, got " + std::to_string(argc));
+    }
+    for (size_t i = 0; i < argc; ++i) {
+        if (!(native.params[i] & (1u << args[i].index()))) [[unlikely]] {
+            throw RuntimeError("argument " + std::to_string(i + 1) + " of '" + native.name + "' can't be '" + operators::typeName(args[i]) + "'");
+        }
+    }
+}
+
+Native meow::runtime::makeStringBuilder(meow::memory::MemoryManager& heap) {
+    static constexpr uint32_t NO_PARAMS[1] = {0};
+    auto construct = [](meow::memory::MemoryManager& heap, const Value*) -> Value {
+        return heap.newObject<ObjStringBuilder>();
+    };
+    return heap.newObject<ObjNative>("StringBuilder", construct, 0, NO_PARAMS);
+}
+
+Value meow::runtime::invokeStringBuilder(meow::memory::MemoryManager& heap, StringBuilder builder, const std::string& name, const Value* args, size_t argc) {
+    auto expect = [&](size_t count) {
+        if (argc != count) {
+            throw RuntimeError("'" + name + "' expects " + std::to_string(count) + " arguments, got " + std::to_string(argc));
+        }
+    };
+    if (name == "append") {
+        for (size_t i = 0; i < argc; ++i) {
+            if (const String* string = args[i].get_if<String>()) builder->buffer += (*string)->get();
+            else builder->buffer += args[i].asString();
+        }
+        return builder;
+    }
+    if (name == "toString") {
+        expect(0);
+        return heap.newObject<ObjString>(builder->buffer);
+    }
+    if (name == "size") {
+        expect(0);
+        return static_cast<Int>(builder->buffer.size());
+    }
+    if (name == "clear") {
+        expect(0);
+        builder->buffer.clear();
+        return builder;
+    }
+    throw RuntimeError("'StringBuilder' has no method '" + name + "'");
+}
@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file operators.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript generic operators
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "runtime/operators.h"
+#include "runtime/runtime_error.h"
+#include "common/definitions.h"
+
+using namespace meow::common;
+using meow::runtime::RuntimeError;
+
+namespace {
+    inline bool isInteger(const Value& value) noexcept {
+        return value.is<Int>() || value.is<BigInt>();
+    }
+
+    inline bool isNumber(const Value& value) noexcept {
+        return value.is<Int>() || value.is<Float>() || value.is<BigInt>();
+    }
+
+    inline BigInteger toBigInteger(const Value& value) {
+        if (const Int* i = value.get_if<Int>()) return BigInteger(*i);
+        return value.get<BigInt>()->get();
+    }
+
+    // Results that fit are demoted back to Int, so only values out of Int range live on the heap
+    Value makeInteger(meow::memory::MemoryManager& heap, BigInteger value) {
+        if (value.fitsInt()) return value.toInt();
+        return heap.newObject<ObjBigInt>(std::move(value));
+    }
+
+    // The result takes at most exponent times the bits of the base, which is checked before allocating it
+    Value bigPower(meow::memory::MemoryManager& heap, const BigInteger& base, uint64_t exponent) {
+        uint64_t bits = base.bitLength();
+        if (bits > 1 && exponent > static_cast<uint64_t>(meow::runtime::operators::MAX_BIG_SHIFT) / bits) {
+            throw RuntimeError("integer too large");
+        }
+        return makeInteger(heap, base.pow(exponent));
+    }
+
+    [[noreturn]] void unsupported(const char* op, const Value& lhs, const Value& rhs) {
+        using meow::runtime::operators::typeName;
+        throw RuntimeError(std::string("unsupported operand types for ") + op + ": '" + typeName(lhs) + "' and '" + typeName(rhs) + "'");
+    }
+
+    [[noreturn]] void unsupported(const char* op, const Value& value) {
+        using meow::runtime::operators::typeName;
+        throw RuntimeError(std::string("unsupported operand type for ") + op + ": '" + typeName(value) + "'");
+    }
+
+    /**
+     * @brief Resolves an index against a container size
+     * @details Negative indices count from the end of the container
+     */
+    size_t checkIndex(const Value& key, size_t size) {
+        const Int* index = key.get_if<Int>();
+        if (!index) {
+            throw RuntimeError("index must be an int, not '" + meow::runtime::operators::typeName(key) + "'");
+        }
+        Int resolved = *index < 0 ? *index + static_cast<Int>(size) : *index;
+        if (resolved < 0 || static_cast<size_t>(resolved) >= size) {
+            throw RuntimeError("index " + std::to_string(*index) + " out of bounds for size " + std::to_string(size));
+        }
+        return static_cast<size_t>(resolved);
+    }
+}
+
+namespace meow::runtime::operators {
+    std::string typeName(const Value& value) {
+        return value.visit(
+            [](Null) -> std::string { return "null"; },
+            [](Int) -> std::string { return "int"; },
+            [](Float) -> std::string { return "float"; },
+            [](Bool) -> std::string { return "bool"; },
+            [](BigInt) -> std::string { return "int"; },
+            [](Bytes) -> std::string { return "bytes"; },
+            [](String) -> std::string { return "string"; },
+            [](Array) -> std::string { return "array"; },
+            [](Object) -> std::string { return "object"; },
+            [](Module) -> std::string { return "module"; },
+            [](Proto) -> std::string { return "function"; },
+            [](Closure) -> std::string { return "function"; },
+            [](Upvalue) -> std::string { return "upvalue"; },
+            [](Native) -> std::string { return "function"; },
+            [](Class) -> std::string { return "class"; },
+            [](Instance instance) -> std::string { return instance->klass->name; },
+            [](BoundMethod) -> std::string { return "function"; },
+            [](StringBuilder) -> std::string { return "StringBuilder"; }
+        );
+    }
+
+    Value add(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) {
+            Int result;
+            if (!__builtin_add_overflow(lhs.get<Int>(), rhs.get<Int>(), &result)) [[likely]] return result;
+            return makeInteger(heap, BigInteger(lhs.get<Int>()) + BigInteger(rhs.get<Int>()));
+        }
+        if (isInteger(lhs) && isInteger(rhs)) {
+            return makeInteger(heap, toBigInteger(lhs) + toBigInteger(rhs));
+        }
+        if (isNumber(lhs) && isNumber(rhs)) {
+            return lhs.asFloat() + rhs.asFloat();
+        }
+        if (lhs.is<String>() || rhs.is<String>()) {
+            return heap.newObject<ObjString>(lhs.asString() + rhs.asString());
+        }
+        if (lhs.is<Array>() && rhs.is<Array>()) {
+            Array result = heap.newObject<ObjArray>(lhs.get<Array>()->get());
+            for (const auto& element : rhs.get<Array>()->get()) {
+                result->push(element);
+            }
+            return result;
+        }
+        unsupported("+", lhs, rhs);
+    }
+
+    Value append(meow::memory::MemoryManager& heap, String lhs, const Value& rhs) {
+        if (const String* suffix = rhs.get_if<String>()) {
+            if (*suffix == lhs) return heap.newObject<ObjString>(lhs->get() + lhs->get());
+            return heap.newObject<ObjString>(*lhs, (*suffix)->get());
+        }
+        return heap.newObject<ObjString>(*lhs, rhs.asString());
+    }
+
+    Value subtract(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) {
+            Int result;
+            if (!__builtin_sub_overflow(lhs.get<Int>(), rhs.get<Int>(), &result)) [[likely]] return result;
+            return makeInteger(heap, BigInteger(lhs.get<Int>()) - BigInteger(rhs.get<Int>()));
+        }
+        if (isInteger(lhs) && isInteger(rhs)) {
+            return makeInteger(heap, toBigInteger(lhs) - toBigInteger(rhs));
+        }
+        if (isNumber(lhs) && isNumber(rhs)) {
+            return lhs.asFloat() - rhs.asFloat();
+        }
+        unsupported("-", lhs, rhs);
+    }
+
+    Value multiply(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) {
+            Int result;
+            if (!__builtin_mul_overflow(lhs.get<Int>(), rhs.get<Int>(), &result)) [[likely]] return result;
+            return makeInteger(heap, BigInteger(lhs.get<Int>()) * BigInteger(rhs.get<Int>()));
+        }
+        if (isInteger(lhs) && isInteger(rhs)) {
+            return makeInteger(heap, toBigInteger(lhs) * toBigInteger(rhs));
+        }
+        if (isNumber(lhs) && isNumber(rhs)) {
+            return lhs.asFloat() * rhs.asFloat();
+        }
+        unsupported("*", lhs, rhs);
+    }
+
+    // Division always produces a float, like Lua's '/'
+    Value divide(const Value& lhs, const Value& rhs) {
+        if (isNumber(lhs) && isNumber(rhs)) {
+            return lhs.asFloat() / rhs.asFloat();
+        }
+        unsupported("/", lhs, rhs);
+    }
+
+    Value modulo(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) {
+            Int divisor = rhs.get<Int>();
+            if (divisor == 0) throw RuntimeError("integer modulo by zero");
+            if (divisor == -1) return Int{0};
+            return lhs.get<Int>() % divisor;
+        }
+        if (isInteger(lhs) && isInteger(rhs)) {
+            BigInteger divisor = toBigInteger(rhs), quotient, remainder;
+            if (divisor.isZero()) throw RuntimeError("integer modulo by zero");
+            BigInteger::divide(toBigInteger(lhs), divisor, quotient, remainder);
+            return makeInteger(heap, std::move(remainder));
+        }
+        if (isNumber(lhs) && isNumber(rhs)) {
+            return std::fmod(lhs.asFloat(), rhs.asFloat());
+        }
+        unsupported("%", lhs, rhs);
+    }
+
+    // Exponentiation by squaring, continuing in arbitrary precision from the first overflow
+    Value power(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>() && rhs.get<Int>() >= 0) {
+            Int base = lhs.get<Int>();
+            uint64_t exponent = static_cast<uint64_t>(rhs.get<Int>());
+            Int result = 1;
+            while (exponent) {
+                if ((exponent & 1) && __builtin_mul_overflow(result, base, &result)) break;
+                exponent >>= 1;
+                if (exponent && __builtin_mul_overflow(base, base, &base)) break;
+            }
+            if (!exponent) return result;
+            return bigPower(heap, BigInteger(lhs.get<Int>()), static_cast<uint64_t>(rhs.get<Int>()));
+        }
+        if (lhs.is<BigInt>() && rhs.is<Int>() && rhs.get<Int>() >= 0) {
+            return bigPower(heap, lhs.get<BigInt>()->get(), static_cast<uint64_t>(rhs.get<Int>()));
+        }
+        if (isNumber(lhs) && isNumber(rhs)) {
+            return std::pow(lhs.asFloat(), rhs.asFloat());
+        }
+        unsupported("**", lhs, rhs);
+    }
+
+    Value negate(meow::memory::MemoryManager& heap, const Value& value) {
+        if (const Int* i = value.get_if<Int>()) {
+            if (*i == std::numeric_limits<Int>::min()) [[unlikely]] return makeInteger(heap, -BigInteger(*i));
+            return -*i;
+        }
+        if (const BigInt* big = value.get_if<BigInt>()) {
+            return makeInteger(heap, -(*big)->get());
+        }
+        if (const Float* f = value.get_if<Float>()) {
+            return -*f;
+        }
+        unsupported("unary -", value);
+    }
+
+    Value bitAnd(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) return lhs.get<Int>() & rhs.get<Int>();
+        if (isInteger(lhs) && isInteger(rhs)) return makeInteger(heap, toBigInteger(lhs) & toBigInteger(rhs));
+        unsupported("&", lhs, rhs);
+    }
+
+    Value bitOr(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) return lhs.get<Int>() | rhs.get<Int>();
+        if (isInteger(lhs) && isInteger(rhs)) return makeInteger(heap, toBigInteger(lhs) | toBigInteger(rhs));
+        unsupported("|", lhs, rhs);
+    }
+
+    Value bitXor(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) return lhs.get<Int>() ^ rhs.get<Int>();
+        if (isInteger(lhs) && isInteger(rhs)) return makeInteger(heap, toBigInteger(lhs) ^ toBigInteger(rhs));
+        unsupported("^", lhs, rhs);
+    }
+
+    Value bitNot(meow::memory::MemoryManager& heap, const Value& value) {
+        if (const Int* i = value.get_if<Int>()) return ~*i;
+        if (const BigInt* big = value.get_if<BigInt>()) return makeInteger(heap, ~(*big)->get());
+        unsupported("~", value);
+    }
+
+    Value shiftLeft(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (isInteger(lhs) && rhs.is<Int>()) {
+            Int shift = rhs.get<Int>();
+            if (shift < 0) throw RuntimeError("negative shift count");
+            if (const Int* value = lhs.get_if<Int>()) {
+                // Fits if shifting back gives the same value, that is, no significant bit is shifted out
+                if (*value == 0) return Int{0};
+                if (shift < 63) {
+                    Int shifted = static_cast<Int>(static_cast<uint64_t>(*value) << shift);
+                    if ((shifted >> shift) == *value) [[likely]] return shifted;
+                }
+            }
+            if (shift > MAX_BIG_SHIFT) throw RuntimeError("shift count too large");
+            return makeInteger(heap, toBigInteger(lhs).shiftLeft(static_cast<uint64_t>(shift)));
+        }
+        unsupported("<<", lhs, rhs);
+    }
+
+    Value shiftRight(meow::memory::MemoryManager& heap, const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) {
+            Int shift = rhs.get<Int>();
+            if (shift < 0) throw RuntimeError("negative shift count");
+            if (shift >= 64) return Int{lhs.get<Int>() < 0 ? -1 : 0};
+            return lhs.get<Int>() >> shift;
+        }
+        if (lhs.is<BigInt>() && rhs.is<Int>()) {
+            Int shift = rhs.get<Int>();
+            if (shift < 0) throw RuntimeError("negative shift count");
+            return makeInteger(heap, lhs.get<BigInt>()->get().shiftRight(static_cast<uint64_t>(shift)));
+        }
+        unsupported(">>", lhs, rhs);
+    }
+
+    bool equals(const Value& lhs, const Value& rhs) {
+        if (isNumber(lhs) && isNumber(rhs)) {
+            if (lhs.is<Int>() && rhs.is<Int>()) return lhs.get<Int>() == rhs.get<Int>();
+            if (isInteger(lhs) && isInteger(rhs)) return toBigInteger(lhs) == toBigInteger(rhs);
+            return lhs.asFloat() == rhs.asFloat();
+        }
+        if (lhs.index() != rhs.index()) return false;
+        if (lhs.is<String>()) {
+            return lhs.get<String>() == rhs.get<String>() || lhs.get<String>()->get() == rhs.get<String>()->get();
+        }
+        return static_cast<const BaseValue&>(lhs) == static_cast<const BaseValue&>(rhs);
+    }
+
+    bool lessThan(const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) return lhs.get<Int>() < rhs.get<Int>();
+        if (isInteger(lhs) && isInteger(rhs)) return compare(toBigInteger(lhs), toBigInteger(rhs)) < 0;
+        if (isNumber(lhs) && isNumber(rhs)) return lhs.asFloat() < rhs.asFloat();
+        if (lhs.is<String>() && rhs.is<String>()) return lhs.get<String>()->get() < rhs.get<String>()->get();
+        unsupported("<", lhs, rhs);
+    }
+
+    bool lessEqual(const Value& lhs, const Value& rhs) {
+        if (lhs.is<Int>() && rhs.is<Int>()) return lhs.get<Int>() <= rhs.get<Int>();
+        if (isInteger(lhs) && isInteger(rhs)) return compare(toBigInteger(lhs), toBigInteger(rhs)) <= 0;
+        if (isNumber(lhs) && isNumber(rhs)) return lhs.asFloat() <= rhs.asFloat();
+        if (lhs.is<String>() && rhs.is<String>()) return lhs.get<String>()->get() <= rhs.get<String>()->get();
+        unsupported("<=", lhs, rhs);
+    }
+
+    Value getIndex(meow::memory::MemoryManager& heap, const Value& container, const Value& key) {
+        if (const Array* array = container.get_if<Array>()) {
+            return (*array)->get(checkIndex(key, (*array)->size()));
+        }
+        if (const Object* object = container.get_if<Object>()) {
+            const String* name = key.get_if<String>();
+            if (!name) throw RuntimeError("object key must be a string, not '" + typeName(key) + "'");
+            return (*object)->has(*name) ? (*object)->get(*name) : Value(Null{});
+        }
+        if (const String* string = container.get_if<String>()) {
+            return heap.newObject<ObjString>(std::string(1, (*string)->get(checkIndex(key, (*string)->size()))));
+        }
+        if (const Bytes* bytes = container.get_if<Bytes>()) {
+            return static_cast<Int>((*bytes)->get(checkIndex(key, (*bytes)->size())));
+        }
+        unsupported("[]", container, key);
+    }
+
+    void setIndex(const Value& container, const Value& key, const Value& value) {
+        if (const Array* array = container.get_if<Array>()) {
+            (*array)->set(checkIndex(key, (*array)->size()), value);
+            return;
+        }
+        if (const Object* object = container.get_if<Object>()) {
+            const String* name = key.get_if<String>();
+            if (!name) throw RuntimeError("object key must be a string, not '" + typeName(key) + "'");
+            (*object)->set(*name, value);
+            return;
+        }
+        if (const Bytes* bytes = container.get_if<Bytes>()) {
+            const Int* byte = value.get_if<Int>();
+            if (!byte || *byte < 0 || *byte > 0xff) throw RuntimeError("byte value must be an int in range [0, 255]");
+            (*bytes)->set(checkIndex(key, (*bytes)->size()), static_cast<uint8_t>(*byte));
+            return;
+        }
+        unsupported("[]=", container, key);
+    }
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file value_stack.cpp
+ * @author lazypaws
+ * @brief Implementation of MeowScript value stack
+ * @copyright Copyright(c) 2025 LazyPaws
+ */
+
+#include "runtime/value_stack.h"
+#include "runtime/runtime_error.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace meow::runtime;
+using meow::common::Value;
+
+namespace {
+    size_t pageSize() noexcept {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    inline size_t roundUp(size_t bytes, size_t page) noexcept {
+        return (bytes + page - 1) / page * page;
+    }
+
+    void* reserve(size_t bytes) {
+#ifdef _WIN32
+        void* memory = VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS);
+        return memory;
+#else
+        void* memory = mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return memory == MAP_FAILED ? nullptr : memory;
+#endif
+    }
+
+    bool commit(void* address, size_t bytes) {
+#ifdef _WIN32
+        return VirtualAlloc(address, bytes, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        return mprotect(address, bytes, PROT_READ | PROT_WRITE) == 0;
+#endif
+    }
+
+    void release(void* address, size_t bytes) {
+#ifdef _WIN32
+        (void)bytes;
+        VirtualFree(address, 0, MEM_RELEASE);
+#else
+        munmap(address, bytes);
+#endif
+    }
+}
+
+ValueStack::ValueStack(size_t maxSlots) : slots(nullptr), committed(0), maxSlots(maxSlots) {
+    // The trailing page is never committed and acts as the guard page
+    reservedBytes = roundUp(maxSlots * sizeof(Value), pageSize()) + pageSize();
+    slots = static_cast<Value*>(reserve(reservedBytes));
+    if (!slots) {
+        throw std::bad_alloc();
+    }
+}
+
+ValueStack::~ValueStack() {
+    std::destroy_n(slots, committed);
+    release(slots, reservedBytes);
+}
+
+void ValueStack::clear() noexcept {
+    std::fill_n(slots, committed, Value());
+}
+
+void ValueStack::grow(size_t needed) {
+    if (needed > maxSlots) {
+        throw RuntimeError("stack overflow");
+    }
+
+    const size_t page = pageSize();
+    size_t target = std::min(maxSlots, std::max(needed, committed * 2));
+    size_t fromBytes = roundUp(committed * sizeof(Value), page);
+    size_t toBytes = roundUp(target * sizeof(Value), page);
+    if (toBytes > fromBytes && !commit(reinterpret_cast<uint8_t*>(slots) + fromBytes, toBytes - fromBytes)) {
+        throw std::bad_alloc();
+    }
+
+    // Uses every slot that fits in the committed pages
+    target = std::min(maxSlots, toBytes / sizeof(Value));
+    std::uninitialized_default_construct(slots + committed, slots + target);
+    committed = target;
+}